@@ -0,0 +1,55 @@
+// Tabel resi/user terakhir disimpan di flash agar menu bisa validasi
+// sebelum WiFi dan Firestore siap (warm boot).
+
+uint32_t tableCacheSavedHash[2];  // users, resi
+
+uint32_t tableCacheHash(const String& data) {
+  uint32_t hash = 2166136261UL;
+  for (size_t i = 0; i < data.length(); i++) {
+    hash ^= (uint8_t)data[i];
+    hash *= 16777619UL;
+  }
+  return hash;
+}
+
+bool readTableCache(const char* key, String& out) {
+  size_t length = preferences.getBytesLength(key);
+  if (length == 0) return false;
+  char* buffer = (char*)malloc(length + 1);
+  if (buffer == nullptr) return false;
+  preferences.getBytes(key, buffer, length);
+  buffer[length] = '\0';
+  out = buffer;
+  free(buffer);
+  return true;
+}
+
+void writeTableCache(const char* key, const String& data) {
+  uint8_t slot = strcmp(key, "users") == 0 ? 0 : 1;
+  uint32_t hash = tableCacheHash(data);
+  if (hash == tableCacheSavedHash[slot]) return;  // hindari tulis flash jika tidak berubah
+  preferences.putBytes(key, data.c_str(), data.length());
+  tableCacheSavedHash[slot] = hash;
+}
+
+void restoreTableCache() {
+  preferences.begin("bootcache", false);
+
+  String cache;
+  uint8_t userCount = 0;
+  uint8_t resiCount = 0;
+  if (readTableCache("users", cache)) {
+    userCount = firestoreDecodeDocuments(cache, userData, USER_MAX);
+    tableCacheSavedHash[0] = tableCacheHash(cache);
+  }
+  if (readTableCache("resi", cache)) {
+    resiCount = firestoreDecodeDocuments(cache, resiData, PAKET_MAX);
+    tableCacheSavedHash[1] = tableCacheHash(cache);
+  }
+
+  Serial.print("| cache users: ");
+  Serial.print(userCount);
+  Serial.print(" resi: ");
+  Serial.print(resiCount);
+  Serial.println();
+}
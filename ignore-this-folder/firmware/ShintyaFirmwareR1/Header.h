@@ -27,6 +27,11 @@
 #include "WiFi.h"
 #include "WiFiClientSecure.h"
 #include "DFRobotDFPlayerMini.h"
+#include "ScanQueue.h"
+#include "FirestoreSchema.h"
+#include "ServoPlanner.h"
+#include "LokerSessions.h"
+#include "QrToken.h"
 
 #define JUST_TESTING 0
 
@@ -50,6 +55,8 @@ SensorModule sensor;
 HardSerial usbSerial;
 
 ////////// Input Module //////////
+// GPIO36/39 tetap di-polling: interrupt di pin ini terkena errata ESP32
+// (interrupt palsu saat ADC/WiFi aktif)
 DigitalIn buttonDown(36);
 DigitalIn buttonOk(39);
 #if JUST_TESTING
@@ -68,6 +75,11 @@ PCF8574DigitalIn limitSwitch9(PCF_PIN0);
 PCF8574DigitalIn limitSwitch10(PCF_PIN1);
 PCF8574DigitalIn limitSwitch11(PCF_PIN2);
 PCF8574DigitalIn limitSwitch12(PCF_PIN3);
+
+PCF8574DigitalIn* limitSwitches[] = {
+  &limitSwitch1, &limitSwitch2, &limitSwitch3, &limitSwitch4, &limitSwitch5, &limitSwitch6,
+  &limitSwitch7, &limitSwitch8, &limitSwitch9, &limitSwitch10, &limitSwitch11, &limitSwitch12
+};
 #endif
 
 ////////// Output Module //////////
@@ -114,6 +126,17 @@ FirebaseRTDBState firebaseRTDBState = RTDB_IDLE;
 FirebaseFirestoreState firebaseFirestoreState = FIRESTORE_IDE;
 FirebaseMessagingState firebaseMessagingState = MESSAGING_IDLE;
 
+// Events raised from callbacks/tasks and delivered to loop() as notification bits
+enum InputEvent : uint32_t {
+  EVENT_SERIAL = 1 << 0,
+  EVENT_SCAN = 1 << 1,
+};
+
+const uint32_t LOOP_IDLE_TIMEOUT_MS = 20;  // button polling and menu refresh
+const uint32_t SCAN_DRAIN_MS = 100;        // batas membaca satu frame GM67 setelah notifikasi
+TaskHandle_t loopTaskHandle = nullptr;
+TaskHandle_t scanTaskHandle = nullptr;
+
 String buttonDownStr = "";
 String buttonOkStr = "";
 
@@ -132,11 +155,99 @@ struct UserData {
   String email;
 };
 
+template<> struct FirestoreSchema<ResiData> {
+  template<typename V, typename D> static void fields(V& v, D& d) {
+    v("nama", d.nama);
+    v("noResi", d.noResi);
+    v("packetType", d.packetType);
+    v("resiId", d.resiId);
+  }
+};
+
+template<> struct FirestoreSchema<UserData> {
+  template<typename V, typename D> static void fields(V& v, D& d) {
+    v("displayName", d.displayName);
+    v("name", d.name);
+    v("email", d.email);
+  }
+};
+
 ResiData resiData[PAKET_MAX];
 UserData userData[USER_MAX];
 
+const uint32_t SCAN_DEBOUNCE_MS = 1500;
+ScanQueue<16> gm67ScanQueue;   // producer: scanTask
+ScanQueue<8> serialScanQueue;  // producer: usbCommunicationTask
+std::atomic<uint32_t> scanFlow{ 0 };  // bertambah tiap flow scan selesai (clearScan)
+
 String resiBarcode = "";
 String userQRCode = "";
 String statusTinggiPaket = "";
 int tinggiPaket = 0;
-bool ambilPaketState = false;
\ No newline at end of file
+
+// Satu sesi per loker (loker_1 .. loker_12) sehingga beberapa kurir/penerima
+// bisa memakai loker berbeda secara bersamaan. Nomor loker diambil dari field
+// resiId dokumen resi (di app disebut nomorLoker); nilai di luar 1..12 ditolak.
+const uint8_t LOKER_MAX = 12;
+const uint32_t LOKER_UNLOCK_TIMEOUT_MS = 30000;  // pintu tidak dibuka -> kunci lagi
+const uint32_t LOKER_DOOR_ALARM_MS = 120000;     // pintu dibiarkan terbuka -> buzzer
+const uint16_t LOKER_SERVO_LOCK = 0;
+const uint16_t LOKER_SERVO_UNLOCK = 240;
+
+// Planner servo dan sesi loker dijalankan lokerTask tiap frame PWM servo,
+// terpisah dari loop() yang diblokir delay() flow menu
+const uint32_t LOKER_TASK_PERIOD_MS = 20;
+SemaphoreHandle_t lokerMutex = nullptr;  // lokerSessions + servoPlanner
+
+// Servo MG90S: ~650 mA inrush, ~250 mA saat bergerak. Budget 1500 mA menjaga
+// rail 5V tetap di atas batas brown-out saat banyak pintu dibuka sekaligus.
+const ServoPlannerConfig SERVO_PLANNER_CONFIG = {
+  1500,  // budgetMa
+  650,   // inrushMa
+  250,   // runMa
+  80,    // inrushMs
+  960,   // unitsPerSecond, 0 -> 240 dalam 250 ms
+  150,   // minMotionMs
+};
+
+ServoPlanner<LOKER_MAX> servoPlanner(
+  SERVO_PLANNER_CONFIG, [](uint8_t channel, uint16_t position) {
+#if JUST_TESTING
+    servoDriver.Servo(channel, position);
+#endif
+  },
+  LOKER_SERVO_LOCK);
+
+const LokerSessionConfig LOKER_SESSION_CONFIG = {
+  LOKER_UNLOCK_TIMEOUT_MS,
+  LOKER_DOOR_ALARM_MS,
+  LOKER_SERVO_LOCK,
+  LOKER_SERVO_UNLOCK,
+};
+
+LokerSessionTable<LOKER_MAX> lokerSessions(
+  LOKER_SESSION_CONFIG, servoPlanner,
+  [](uint8_t nomorLoker) -> bool {
+#if JUST_TESTING
+    return limitSwitches[nomorLoker - 1]->getState() == LOW;  // tertekan saat pintu tertutup
+#else
+    return true;
+#endif
+  },
+  [](uint8_t nomorLoker, const LokerSession& session, bool completed) {
+    Serial.print("| loker_");
+    Serial.print(nomorLoker);
+    Serial.print(session.type == SESSION_DEPOSIT ? " deposit " : " pickup ");
+    Serial.print(session.owner);
+    Serial.print(completed ? " selesai" : " kadaluarsa");
+    Serial.println();
+  });
+
+// QR user terenkripsi, harus sama dengan AESV3Instances.userQR di
+// services/aesEncryptionServiceV3.js
+const char QR_USER_SECRET[] = "SHINTYA_AES_USER_2024";
+const char QR_USER_DERIVATION[] = "user_qr";
+const time_t QR_MIN_VALID_EPOCH = 1700000000;  // jam sistem (SNTP, lihat wifiTask) belum sinkron di bawah ini
+const bool QR_ALLOW_PLAINTEXT = true;           // QR lama berisi name user (USER#nama), matikan setelah app memakai AES V3
+
+QrTokenVerifier userQRVerifier;
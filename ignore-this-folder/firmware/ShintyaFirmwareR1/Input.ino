@@ -0,0 +1,13 @@
+void initializeInputEvents() {
+  loopTaskHandle = xTaskGetCurrentTaskHandle();
+
+  Serial.onReceive([]() {
+    xTaskNotify(loopTaskHandle, EVENT_SERIAL, eSetBits);
+  });
+}
+
+uint32_t waitForInputEvents(uint32_t timeoutMs) {
+  uint32_t events = 0;
+  xTaskNotifyWait(0, UINT32_MAX, &events, pdMS_TO_TICKS(timeoutMs));
+  return events;
+}
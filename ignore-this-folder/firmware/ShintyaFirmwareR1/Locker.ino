@@ -0,0 +1,55 @@
+bool isLokerValid(int nomorLoker) {
+  return lokerSessions.isValid(nomorLoker);
+}
+
+// Dipanggil dari flow menu (loop); servo mulai bergerak di frame lokerTask
+// berikutnya, bukan setelah delay() flow selesai
+bool openLokerSession(int nomorLoker, LokerSessionType type, const String& owner) {
+  if (!isLokerValid(nomorLoker)) {
+    Serial.print("| loker tidak valid: ");
+    Serial.print(nomorLoker);
+    Serial.println();
+    return false;
+  }
+  xSemaphoreTake(lokerMutex, portMAX_DELAY);
+  bool opened = lokerSessions.open(nomorLoker, type, owner, millis());
+  xSemaphoreGive(lokerMutex);
+
+  if (opened) {
+    Serial.print("| loker_");
+    Serial.print(nomorLoker);
+    Serial.print(" unlocked");
+    Serial.println();
+  }
+  return opened;
+}
+
+// Dipanggil dari lokerTask dengan lokerMutex, tidak pernah blocking
+void updateLokerSessions() {
+  static bool alarmActive = false;
+  bool alarm = lokerSessions.update(millis());
+
+  if (alarm) buzzer.toggleAsync(250);
+  else if (alarmActive) buzzer.off();
+  alarmActive = alarm;
+}
+
+void lokerTask() {
+  lokerMutex = xSemaphoreCreateMutex();
+  task.setInitCoreID(1);
+  task.createTask(4096, [](void* pvParameter) {
+    TickType_t lastWake = xTaskGetTickCount();
+    for (;;) {
+#if JUST_TESTING
+      PCF8574DigitalIn::updateAll(&limitSwitch1, &limitSwitch2, &limitSwitch3, &limitSwitch4, &limitSwitch5, &limitSwitch6, &limitSwitch7, &limitSwitch8, &limitSwitch9, &limitSwitch10, &limitSwitch11, &limitSwitch12, PCF8574DigitalIn::stop());
+#endif
+      xSemaphoreTake(lokerMutex, portMAX_DELAY);
+      servoPlanner.update(millis());
+      updateLokerSessions();
+      xSemaphoreGive(lokerMutex);
+
+      DigitalOut::updateAll(&buzzer, &ledRed, &ledGreen, &ledYellow, &relayA, &relayB, DigitalOut::stop());
+      vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(LOKER_TASK_PERIOD_MS));
+    }
+  });
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <Arduino.h>
+#include "ServoPlanner.h"
+
+////////// Loker Sessions //////////
+// Tabel sesi per loker (loker_1 .. loker_N). Setiap loker menjalankan state
+// machine sendiri: kunci dibuka -> pintu dibuka -> pintu ditutup -> kunci,
+// sehingga beberapa kurir/penerima bisa memakai loker berbeda bersamaan.
+// Kunci digerakkan lewat ServoPlanner (ikut antrian budget arus), pintu dibaca
+// lewat LokerDoorReader, dan penutupan sesi dilaporkan ke LokerSessionListener.
+// Tidak memegang mutex sendiri: pemanggil (lokerTask/flow menu) yang mengunci.
+// Tanpa hardware sehingga bisa disimulasikan di host (lihat tests/firmware).
+
+enum LokerSessionType : uint8_t {
+  SESSION_DEPOSIT,
+  SESSION_PICKUP,
+};
+
+enum LokerSessionState : uint8_t {
+  LOKER_IDLE,
+  LOKER_UNLOCKED,   // kunci dibuka, menunggu pintu dibuka
+  LOKER_DOOR_OPEN,  // pintu terbuka, menunggu pintu ditutup
+};
+
+struct LokerSession {
+  LokerSessionState state;
+  LokerSessionType type;
+  String owner;  // noResi (deposit) atau name user (pickup)
+  uint32_t startTime;
+  uint32_t stateSince;
+  bool alarm;
+};
+
+struct LokerSessionConfig {
+  uint32_t unlockTimeoutMs;  // pintu tidak dibuka -> kunci lagi
+  uint32_t doorAlarmMs;      // pintu dibiarkan terbuka -> alarm
+  uint16_t lockPosition;
+  uint16_t unlockPosition;
+};
+
+struct LokerSessionStats {
+  uint32_t opened;
+  uint32_t rejected;       // loker tidak valid atau sedang dipakai
+  uint32_t completed;      // pintu dibuka lalu ditutup
+  uint32_t expired;        // pintu tidak pernah dibuka
+  uint32_t durationTotal;  // startTime -> kunci lagi, sesi completed
+  uint32_t durationMax;
+  uint8_t peakActive;
+};
+
+typedef bool (*LokerDoorReader)(uint8_t nomorLoker);  // true jika pintu tertutup
+typedef void (*LokerSessionListener)(uint8_t nomorLoker, const LokerSession& session, bool completed);
+
+template<uint8_t N>
+class LokerSessionTable {
+public:
+  LokerSessionTable(const LokerSessionConfig& config, ServoPlanner<N>& planner,
+                    LokerDoorReader doorClosed, LokerSessionListener onClose = nullptr)
+    : config(config), planner(planner), doorClosed(doorClosed), onClose(onClose) {}
+
+  bool isValid(int nomorLoker) const {
+    return nomorLoker >= 1 && nomorLoker <= N;
+  }
+
+  bool isBusy(int nomorLoker) const {
+    return isValid(nomorLoker) && sessions[nomorLoker - 1].state != LOKER_IDLE;
+  }
+
+  // Servo mulai bergerak di update() planner berikutnya, tidak blocking
+  bool open(int nomorLoker, LokerSessionType type, const String& owner, uint32_t now) {
+    if (!isValid(nomorLoker) || isBusy(nomorLoker)) {
+      stats.rejected++;
+      return false;
+    }
+
+    LokerSession& session = sessions[nomorLoker - 1];
+    session.type = type;
+    session.owner = owner;
+    session.startTime = now;
+    session.stateSince = now;
+    session.alarm = false;
+    session.state = LOKER_UNLOCKED;
+    planner.request(nomorLoker - 1, config.unlockPosition, now);
+
+    stats.opened++;
+    uint8_t active = activeCount();
+    if (active > stats.peakActive) stats.peakActive = active;
+    return true;
+  }
+
+  // Dipanggil tiap frame setelah planner.update(); return true jika ada
+  // pintu yang dibiarkan terbuka melewati doorAlarmMs
+  bool update(uint32_t now) {
+    bool alarm = false;
+    for (uint8_t i = 0; i < N; i++) {
+      LokerSession& session = sessions[i];
+      uint8_t nomorLoker = i + 1;
+
+      switch (session.state) {
+        case LOKER_IDLE:
+          break;
+        case LOKER_UNLOCKED:
+          // Timeout dihitung sejak kunci benar-benar terbuka (servo bisa antri budget)
+          if (!planner.isSettled(i)) {
+            session.stateSince = now;
+          } else if (!isDoorClosed(nomorLoker)) {
+            session.state = LOKER_DOOR_OPEN;
+            session.stateSince = now;
+          } else if (now - session.stateSince >= config.unlockTimeoutMs) {
+            // Tanpa limit switch (JUST_TESTING 0) pintu tidak pernah terdeteksi
+            // terbuka, jadi sesi selalu berakhir di sini sebagai kadaluarsa
+            close(i, false, now);
+          }
+          break;
+        case LOKER_DOOR_OPEN:
+          if (isDoorClosed(nomorLoker)) {
+            close(i, true, now);
+          } else if (now - session.stateSince >= config.doorAlarmMs) {
+            session.alarm = true;
+          }
+          break;
+      }
+      alarm |= session.alarm;
+    }
+    return alarm;
+  }
+
+  uint8_t activeCount() const {
+    uint8_t active = 0;
+    for (uint8_t i = 0; i < N; i++) {
+      if (sessions[i].state != LOKER_IDLE) active++;
+    }
+    return active;
+  }
+
+  const LokerSession& get(int nomorLoker) const {
+    return sessions[isValid(nomorLoker) ? nomorLoker - 1 : 0];
+  }
+
+  const LokerSessionStats& getStats() const {
+    return stats;
+  }
+
+private:
+  bool isDoorClosed(uint8_t nomorLoker) const {
+    return doorClosed == nullptr || doorClosed(nomorLoker);
+  }
+
+  void close(uint8_t index, bool completed, uint32_t now) {
+    LokerSession& session = sessions[index];
+    planner.request(index, config.lockPosition, now);
+    if (onClose != nullptr) onClose(index + 1, session, completed);
+
+    if (completed) {
+      uint32_t duration = now - session.startTime;
+      stats.completed++;
+      stats.durationTotal += duration;
+      if (duration > stats.durationMax) stats.durationMax = duration;
+    } else {
+      stats.expired++;
+    }
+
+    session.state = LOKER_IDLE;
+    session.owner = "";
+    session.alarm = false;
+  }
+
+  LokerSessionConfig config;
+  ServoPlanner<N>& planner;
+  LokerDoorReader doorClosed;
+  LokerSessionListener onClose;
+  LokerSession sessions[N]{};
+  LokerSessionStats stats{};
+};
@@ -6,6 +6,7 @@ void onLcdMenu() {
     if (!buttonOkStr.isEmpty()) {
       menu.clearMenu(menuNonCOD, menuMain, menu.end());
     }
+    if (resiBarcode.isEmpty()) takeScan(SCAN_RESI, resiBarcode);
     if (!resiBarcode.isEmpty()) {
       menu.formatMenu(menuNonCOD, 3, "[%s]", resiBarcode.c_str());
       menu.showMenu(menuNonCOD, true);
@@ -34,15 +35,28 @@ void onLcdMenu() {
           menu.showMenu(menuNonCODCheck, true);
           delay(4000);
           menu.clearMenu(menuNonCOD, menuMain, menu.end());
-          resiBarcode = "";
+          clearScan(resiBarcode);
+          menu.freeMenu(menuNonCODCheck);
+          return;
+        }
+        int nomorLoker = resiData[indexResiTerdaftar].resiId;
+        bool lokerValid = isLokerValid(nomorLoker);
+        if (!lokerValid || !openLokerSession(nomorLoker, SESSION_DEPOSIT, resiBarcode)) {
+          menu.formatMenu(menuNonCODCheck, 2, "%s", lokerValid ? "  Loker Sedang   " : "  Nomor Loker    ");
+          menu.formatMenu(menuNonCODCheck, 3, "%s", lokerValid ? "    Digunakan    " : "   Tidak Valid   ");
+          menu.showMenu(menuNonCODCheck, true);
+          delay(4000);
+          menu.clearMenu(menuNonCOD, menuMain, menu.end());
+          clearScan(resiBarcode);
           menu.freeMenu(menuNonCODCheck);
           return;
         }
         menu.formatMenu(menuNonCODCheck, 2, "%s", "   Nomor Resi    ");
         menu.formatMenu(menuNonCODCheck, 3, "%s", "    Terdaftar    ");
         menu.showMenu(menuNonCODCheck, true);
-        delay(4000);
-        auto menuNonCODResiTerdaftar = menu.createMenu(4, "    [NON-COD]    ", "  Pintu Terbuka  ", "  Mohon Tunggu   ", "");
+        delay(2000);
+        auto menuNonCODResiTerdaftar = menu.createMenu(4, "    [NON-COD]    ", "  Pintu Terbuka  ", "", "");
+        menu.formatMenu(menuNonCODResiTerdaftar, 3, "    Loker %02d     ", nomorLoker);
         menu.showMenu(menuNonCODResiTerdaftar, true);
         delay(2000);
         auto menuNonCODMasukanPaket = menu.createMenu(4, "    [NON-COD]    ", "    Silahkan     ", " Memasukan Paket ", "");
@@ -52,7 +66,7 @@ void onLcdMenu() {
         menu.showMenu(menuNonCODTerimaKasih, true);
         delay(2000);
         menu.clearMenu(menuNonCOD, menuMain, menu.end());
-        resiBarcode = "";
+        clearScan(resiBarcode);
         menu.freeMenu(menuNonCODCheck);
         menu.freeMenu(menuNonCODResiTerdaftar);
         menu.freeMenu(menuNonCODMasukanPaket);
@@ -64,7 +78,7 @@ void onLcdMenu() {
         menu.showMenu(menuNonCODCheck, true);
         delay(4000);
         menu.clearMenu(menuNonCOD, menuMain, menu.end());
-        resiBarcode = "";
+        clearScan(resiBarcode);
         menu.freeMenu(menuNonCODCheck);
         return;
       }
@@ -77,6 +91,7 @@ void onLcdMenu() {
     if (!buttonOkStr.isEmpty()) {
       menu.clearMenu(menuCOD, menuMain, menu.end());
     }
+    if (resiBarcode.isEmpty()) takeScan(SCAN_RESI, resiBarcode);
     if (!resiBarcode.isEmpty()) {
       menu.formatMenu(menuCOD, 3, "[%s]", resiBarcode.c_str());
       menu.showMenu(menuCOD, true);
@@ -105,15 +120,28 @@ void onLcdMenu() {
           menu.showMenu(menuCODCheck, true);
           delay(4000);
           menu.clearMenu(menuCOD, menuMain, menu.end());
-          resiBarcode = "";
+          clearScan(resiBarcode);
+          menu.freeMenu(menuCODCheck);
+          return;
+        }
+        int nomorLoker = resiData[indexResiTerdaftar].resiId;
+        bool lokerValid = isLokerValid(nomorLoker);
+        if (!lokerValid || !openLokerSession(nomorLoker, SESSION_DEPOSIT, resiBarcode)) {
+          menu.formatMenu(menuCODCheck, 2, "%s", lokerValid ? "  Loker Sedang   " : "  Nomor Loker    ");
+          menu.formatMenu(menuCODCheck, 3, "%s", lokerValid ? "    Digunakan    " : "   Tidak Valid   ");
+          menu.showMenu(menuCODCheck, true);
+          delay(4000);
+          menu.clearMenu(menuCOD, menuMain, menu.end());
+          clearScan(resiBarcode);
           menu.freeMenu(menuCODCheck);
           return;
         }
         menu.formatMenu(menuCODCheck, 2, "%s", "   Nomor Resi    ");
         menu.formatMenu(menuCODCheck, 3, "%s", "    Terdaftar    ");
         menu.showMenu(menuCODCheck, true);
-        delay(4000);
-        auto menuCODResiTerdaftar = menu.createMenu(4, "      [COD]      ", "  Pintu Terbuka  ", "  Mohon Tunggu   ", "");
+        delay(2000);
+        auto menuCODResiTerdaftar = menu.createMenu(4, "      [COD]      ", "  Pintu Terbuka  ", "", "");
+        menu.formatMenu(menuCODResiTerdaftar, 3, "    Loker %02d     ", nomorLoker);
         menu.showMenu(menuCODResiTerdaftar, true);
         delay(2000);
         auto menuCODMasukanPaket = menu.createMenu(4, "      [COD]      ", "    Silahkan     ", " Memasukan Paket ", "");
@@ -126,7 +154,7 @@ void onLcdMenu() {
         menu.showMenu(menuCODTerimaKasih, true);
         delay(2000);
         menu.clearMenu(menuCOD, menuMain, menu.end());
-        resiBarcode = "";
+        clearScan(resiBarcode);
         menu.freeMenu(menuCODCheck);
         menu.freeMenu(menuCODResiTerdaftar);
         menu.freeMenu(menuCODMasukanPaket);
@@ -139,7 +167,7 @@ void onLcdMenu() {
         menu.showMenu(menuCODCheck, true);
         delay(4000);
         menu.clearMenu(menuCOD, menuMain, menu.end());
-        resiBarcode = "";
+        clearScan(resiBarcode);
         menu.freeMenu(menuCODCheck);
         return;
       }
@@ -149,51 +177,52 @@ void onLcdMenu() {
 
   menu.onSelect(menuMain, "Ambil Paket", []() {
     static auto menuAmbilPaket = menu.createMenu(4, "  [AMBIL PAKET]  ", "  Silahkan Scan  ", "  QR Code Anda   ", "");
-    if (!ambilPaketState) {
-      if (!buttonOkStr.isEmpty()) {
-        menu.clearMenu(menuAmbilPaket, menuMain, menu.end());
-      }
-      if (!userQRCode.isEmpty()) {
-        menu.formatMenu(menuAmbilPaket, 3, "[%s]", userQRCode.c_str());
-        menu.showMenu(menuAmbilPaket, true);
-        delay(2000);
-        bool qrCodeTerdaftar = false;
-        for (int i = 0; i < USER_MAX; i++) {
-          if (userQRCode == userData[i].name) {
-            qrCodeTerdaftar = true;
-            break;
+    if (!buttonOkStr.isEmpty()) {
+      menu.clearMenu(menuAmbilPaket, menuMain, menu.end());
+    }
+    if (userQRCode.isEmpty()) takeScan(SCAN_USER, userQRCode);
+    if (!userQRCode.isEmpty()) {
+      bool qrCodeToken = QrTokenVerifier::isToken(userQRCode.c_str());
+      menu.formatMenu(menuAmbilPaket, 3, "[%s]", qrCodeToken ? "QR Terenkripsi" : userQRCode.c_str());
+      menu.showMenu(menuAmbilPaket, true);
+      delay(2000);
+      int indexUser = findUserByQR(userQRCode);
+      if (indexUser >= 0) {
+        String namaUser = userData[indexUser].name;
+        // Buka semua loker berisi paket user ini, pintu dikunci otomatis
+        // per loker saat limit switch mendeteksi pintu tertutup
+        String lokerTerbuka = "";
+        for (int i = 0; i < PAKET_MAX; i++) {
+          if (resiData[i].nama == namaUser && openLokerSession(resiData[i].resiId, SESSION_PICKUP, namaUser)) {
+            if (!lokerTerbuka.isEmpty()) lokerTerbuka += ",";
+            lokerTerbuka += String(resiData[i].resiId);
           }
         }
-        if (qrCodeTerdaftar) {
-          auto menuAmbilPaketBerhasil = menu.createMenu(4, "  [AMBIL PAKET]  ", "  QR Code Anda   ", "Terdaftar, Pintu ", "  Akan Terbuka   ");
-          menu.showMenu(menuAmbilPaketBerhasil, true);
-          delay(4000);
-          menu.freeMenu(menuAmbilPaketBerhasil);
-          // menu.clearMenu(menuMain, menu.end());
-          menu.formatMenu(menuAmbilPaket, 3, "[%s]", "                 ");
-          userQRCode = "";
-          ambilPaketState = true;
-          return;
+        auto menuAmbilPaketBerhasil = menu.createMenu(4, "  [AMBIL PAKET]  ", " QR Terdaftar,   ", "", "");
+        if (lokerTerbuka.isEmpty()) {
+          menu.formatMenu(menuAmbilPaketBerhasil, 2, "%s", "   Tidak Ada     ");
+          menu.formatMenu(menuAmbilPaketBerhasil, 3, "%s", "   Paket Anda    ");
         } else {
-          auto menuAmbilPaketGagal = menu.createMenu(4, "  [AMBIL PAKET]  ", "  QR Code Anda   ", " Tidak Terdafar  ", "");
-          menu.showMenu(menuAmbilPaketGagal, true);
-          delay(2000);
-          menu.freeMenu(menuAmbilPaketGagal);
-          menu.clearMenu(menuMain, menu.end());
-          menu.formatMenu(menuAmbilPaket, 3, "[%s]", "                 ");
-          userQRCode = "";
-          return;
+          menu.formatMenu(menuAmbilPaketBerhasil, 2, "%s", "  Loker Terbuka  ");
+          menu.formatMenu(menuAmbilPaketBerhasil, 3, "[%s]", lokerTerbuka.c_str());
         }
-      }
-    } else {
-      static auto menuAmbilPaketOK = menu.createMenu(4, "  [AMBIL PAKET]  ", "  Tekan Tombol   ", "    OK Untuk     ", " Mengunci Pintu  ");
-      menu.showMenu(menuAmbilPaketOK);
-      if (!buttonOkStr.isEmpty()) {
+        menu.showMenu(menuAmbilPaketBerhasil, true);
+        delay(4000);
+        menu.freeMenu(menuAmbilPaketBerhasil);
         menu.clearMenu(menuAmbilPaket, menuMain, menu.end());
-        userQRCode = "";
-        ambilPaketState = false;
+        menu.formatMenu(menuAmbilPaket, 3, "[%s]", "                 ");
+        clearScan(userQRCode);
+        return;
+      } else {
+        auto menuAmbilPaketGagal = menu.createMenu(4, "  [AMBIL PAKET]  ", "  QR Code Anda   ", " Tidak Terdafar  ", "");
+        menu.showMenu(menuAmbilPaketGagal, true);
+        delay(2000);
+        menu.freeMenu(menuAmbilPaketGagal);
+        menu.clearMenu(menuMain, menu.end());
+        menu.formatMenu(menuAmbilPaket, 3, "[%s]", "                 ");
+        clearScan(userQRCode);
+        return;
       }
-      return;
     }
     menu.showMenu(menuAmbilPaket);
   });
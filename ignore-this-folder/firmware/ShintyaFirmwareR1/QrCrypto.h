@@ -0,0 +1,390 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+////////// QR Crypto //////////
+// Primitive kripto untuk verifikasi QR AES V3 (SHA-256, MD5, AES-256-CBC).
+// Di ESP32 memakai mbedtls bawaan core sehingga SHA-256 dan AES berjalan di
+// akselerator hardware; build host memakai implementasi portable di bawah.
+
+#if defined(ESP_PLATFORM)
+
+#include "mbedtls/aes.h"
+#include "mbedtls/md.h"
+
+class QrDigest {
+public:
+  explicit QrDigest(mbedtls_md_type_t type) {
+    mbedtls_md_init(&ctx);
+    mbedtls_md_setup(&ctx, mbedtls_md_info_from_type(type), 0);
+  }
+  ~QrDigest() {
+    mbedtls_md_free(&ctx);
+  }
+  void begin() {
+    mbedtls_md_starts(&ctx);
+  }
+  void update(const uint8_t* data, size_t len) {
+    mbedtls_md_update(&ctx, data, len);
+  }
+  void finish(uint8_t* out) {
+    mbedtls_md_finish(&ctx, out);
+  }
+
+private:
+  QrDigest(const QrDigest&) = delete;
+  QrDigest& operator=(const QrDigest&) = delete;
+  mbedtls_md_context_t ctx;
+};
+
+class QrSha256 : public QrDigest {
+public:
+  static const size_t SIZE = 32;
+  static const size_t BLOCK = 64;
+  QrSha256() : QrDigest(MBEDTLS_MD_SHA256) {}
+};
+
+class QrMd5 : public QrDigest {
+public:
+  static const size_t SIZE = 16;
+  QrMd5() : QrDigest(MBEDTLS_MD_MD5) {}
+};
+
+class QrAes256Cbc {
+public:
+  QrAes256Cbc() {
+    mbedtls_aes_init(&ctx);
+  }
+  ~QrAes256Cbc() {
+    mbedtls_aes_free(&ctx);
+  }
+  void setDecryptKey(const uint8_t* key) {
+    mbedtls_aes_setkey_dec(&ctx, key, 256);
+  }
+  // iv diperbarui seperti mbedtls_aes_crypt_cbc, len kelipatan 16
+  void decrypt(uint8_t* iv, const uint8_t* in, uint8_t* out, size_t len) {
+    mbedtls_aes_crypt_cbc(&ctx, MBEDTLS_AES_DECRYPT, len, iv, in, out);
+  }
+
+private:
+  QrAes256Cbc(const QrAes256Cbc&) = delete;
+  QrAes256Cbc& operator=(const QrAes256Cbc&) = delete;
+  mbedtls_aes_context ctx;
+};
+
+#else
+
+class QrSha256 {
+public:
+  static const size_t SIZE = 32;
+  static const size_t BLOCK = 64;
+
+  void begin() {
+    static const uint32_t init[8] = {
+      0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+    memcpy(state, init, sizeof(state));
+    total = 0;
+    used = 0;
+  }
+
+  void update(const uint8_t* data, size_t len) {
+    total += len;
+    while (len > 0) {
+      size_t take = BLOCK - used < len ? BLOCK - used : len;
+      memcpy(buffer + used, data, take);
+      used += take;
+      data += take;
+      len -= take;
+      if (used == BLOCK) {
+        compress(buffer);
+        used = 0;
+      }
+    }
+  }
+
+  void finish(uint8_t* out) {
+    uint64_t bits = total * 8;
+    uint8_t pad = 0x80;
+    update(&pad, 1);
+    pad = 0;
+    while (used != 56) update(&pad, 1);
+    uint8_t length[8];
+    for (uint8_t i = 0; i < 8; i++) length[i] = (uint8_t)(bits >> (56 - 8 * i));
+    update(length, 8);
+    for (uint8_t i = 0; i < 8; i++) {
+      out[4 * i] = (uint8_t)(state[i] >> 24);
+      out[4 * i + 1] = (uint8_t)(state[i] >> 16);
+      out[4 * i + 2] = (uint8_t)(state[i] >> 8);
+      out[4 * i + 3] = (uint8_t)state[i];
+    }
+  }
+
+private:
+  static uint32_t rotr(uint32_t x, uint8_t n) {
+    return (x >> n) | (x << (32 - n));
+  }
+
+  void compress(const uint8_t* block) {
+    static const uint32_t k[64] = {
+      0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+      0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+      0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+      0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+      0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+      0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+      0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+      0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
+    uint32_t w[64];
+    for (uint8_t i = 0; i < 16; i++) {
+      w[i] = (uint32_t)block[4 * i] << 24 | (uint32_t)block[4 * i + 1] << 16 | (uint32_t)block[4 * i + 2] << 8 | block[4 * i + 3];
+    }
+    for (uint8_t i = 16; i < 64; i++) {
+      uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+      uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+      w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    for (uint8_t i = 0; i < 64; i++) {
+      uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + k[i] + w[i];
+      uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+      h = g;
+      g = f;
+      f = e;
+      e = d + t1;
+      d = c;
+      c = b;
+      b = a;
+      a = t1 + t2;
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+  }
+
+  uint32_t state[8];
+  uint64_t total;
+  uint8_t buffer[BLOCK];
+  size_t used;
+};
+
+class QrMd5 {
+public:
+  static const size_t SIZE = 16;
+
+  void begin() {
+    state[0] = 0x67452301;
+    state[1] = 0xefcdab89;
+    state[2] = 0x98badcfe;
+    state[3] = 0x10325476;
+    total = 0;
+    used = 0;
+  }
+
+  void update(const uint8_t* data, size_t len) {
+    total += len;
+    while (len > 0) {
+      size_t take = 64 - used < len ? 64 - used : len;
+      memcpy(buffer + used, data, take);
+      used += take;
+      data += take;
+      len -= take;
+      if (used == 64) {
+        compress(buffer);
+        used = 0;
+      }
+    }
+  }
+
+  void finish(uint8_t* out) {
+    uint64_t bits = total * 8;
+    uint8_t pad = 0x80;
+    update(&pad, 1);
+    pad = 0;
+    while (used != 56) update(&pad, 1);
+    uint8_t length[8];
+    for (uint8_t i = 0; i < 8; i++) length[i] = (uint8_t)(bits >> (8 * i));
+    update(length, 8);
+    for (uint8_t i = 0; i < 4; i++) {
+      out[4 * i] = (uint8_t)state[i];
+      out[4 * i + 1] = (uint8_t)(state[i] >> 8);
+      out[4 * i + 2] = (uint8_t)(state[i] >> 16);
+      out[4 * i + 3] = (uint8_t)(state[i] >> 24);
+    }
+  }
+
+private:
+  void compress(const uint8_t* block) {
+    static const uint32_t k[64] = {
+      0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+      0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+      0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+      0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+      0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+      0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+      0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+      0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+    };
+    static const uint8_t r[64] = {
+      7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+      5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20,
+      4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+      6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21
+    };
+    uint32_t m[16];
+    for (uint8_t i = 0; i < 16; i++) {
+      m[i] = block[4 * i] | (uint32_t)block[4 * i + 1] << 8 | (uint32_t)block[4 * i + 2] << 16 | (uint32_t)block[4 * i + 3] << 24;
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    for (uint8_t i = 0; i < 64; i++) {
+      uint32_t f;
+      uint8_t g;
+      if (i < 16) {
+        f = (b & c) | (~b & d);
+        g = i;
+      } else if (i < 32) {
+        f = (d & b) | (~d & c);
+        g = (5 * i + 1) & 15;
+      } else if (i < 48) {
+        f = b ^ c ^ d;
+        g = (3 * i + 5) & 15;
+      } else {
+        f = c ^ (b | ~d);
+        g = (7 * i) & 15;
+      }
+      uint32_t x = a + f + k[i] + m[g];
+      a = d;
+      d = c;
+      c = b;
+      b = b + ((x << r[i]) | (x >> (32 - r[i])));
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+  }
+
+  uint32_t state[4];
+  uint64_t total;
+  uint8_t buffer[64];
+  size_t used;
+};
+
+class QrAes256Cbc {
+public:
+  void setDecryptKey(const uint8_t* key) {
+    const uint8_t* sbox = tables().sbox;
+    memcpy(roundKey, key, 32);
+    uint8_t rcon = 1;
+    for (uint8_t i = 8; i < 60; i++) {
+      uint8_t t[4];
+      memcpy(t, roundKey + 4 * (i - 1), 4);
+      if (i % 8 == 0) {
+        uint8_t first = t[0];
+        t[0] = sbox[t[1]] ^ rcon;
+        t[1] = sbox[t[2]];
+        t[2] = sbox[t[3]];
+        t[3] = sbox[first];
+        rcon = xtime(rcon);
+      } else if (i % 8 == 4) {
+        for (uint8_t j = 0; j < 4; j++) t[j] = sbox[t[j]];
+      }
+      for (uint8_t j = 0; j < 4; j++) roundKey[4 * i + j] = roundKey[4 * (i - 8) + j] ^ t[j];
+    }
+  }
+
+  void decrypt(uint8_t* iv, const uint8_t* in, uint8_t* out, size_t len) {
+    uint8_t block[16];
+    uint8_t next[16];
+    for (size_t offset = 0; offset + 16 <= len; offset += 16) {
+      memcpy(block, in + offset, 16);
+      memcpy(next, block, 16);
+      decryptBlock(block);
+      for (uint8_t i = 0; i < 16; i++) out[offset + i] = block[i] ^ iv[i];
+      memcpy(iv, next, 16);
+    }
+  }
+
+private:
+  static uint8_t xtime(uint8_t x) {
+    return (uint8_t)((x << 1) ^ ((x & 0x80) ? 0x1b : 0));
+  }
+
+  static uint8_t multiply(uint8_t a, uint8_t b) {
+    uint8_t result = 0;
+    while (b) {
+      if (b & 1) result ^= a;
+      a = xtime(a);
+      b >>= 1;
+    }
+    return result;
+  }
+
+  // S-box dibangkitkan sekali dari invers GF(2^8) + transformasi affine
+  struct Tables {
+    uint8_t sbox[256];
+    uint8_t invSbox[256];
+
+    Tables() {
+      uint8_t p = 1, q = 1;
+      do {
+        p = p ^ (uint8_t)(p << 1) ^ ((p & 0x80) ? 0x1b : 0);
+        q ^= q << 1;
+        q ^= q << 2;
+        q ^= q << 4;
+        if (q & 0x80) q ^= 0x09;
+        uint8_t s = q ^ (uint8_t)((q << 1) | (q >> 7)) ^ (uint8_t)((q << 2) | (q >> 6)) ^ (uint8_t)((q << 3) | (q >> 5)) ^ (uint8_t)((q << 4) | (q >> 4));
+        sbox[p] = s ^ 0x63;
+      } while (p != 1);
+      sbox[0] = 0x63;
+      for (uint16_t i = 0; i < 256; i++) invSbox[sbox[i]] = (uint8_t)i;
+    }
+  };
+
+  static const Tables& tables() {
+    static const Tables instance;
+    return instance;
+  }
+
+  void decryptBlock(uint8_t* s) {
+    const uint8_t* invSbox = tables().invSbox;
+    addRoundKey(s, 14);
+    for (uint8_t round = 13;; round--) {
+      // InvShiftRows + InvSubBytes
+      uint8_t t[16];
+      for (uint8_t c = 0; c < 4; c++) {
+        for (uint8_t r = 0; r < 4; r++) t[4 * ((c + r) & 3) + r] = invSbox[s[4 * c + r]];
+      }
+      memcpy(s, t, 16);
+      addRoundKey(s, round);
+      if (round == 0) break;
+      for (uint8_t c = 0; c < 4; c++) {
+        uint8_t* col = s + 4 * c;
+        uint8_t a0 = col[0], a1 = col[1], a2 = col[2], a3 = col[3];
+        col[0] = multiply(a0, 14) ^ multiply(a1, 11) ^ multiply(a2, 13) ^ multiply(a3, 9);
+        col[1] = multiply(a0, 9) ^ multiply(a1, 14) ^ multiply(a2, 11) ^ multiply(a3, 13);
+        col[2] = multiply(a0, 13) ^ multiply(a1, 9) ^ multiply(a2, 14) ^ multiply(a3, 11);
+        col[3] = multiply(a0, 11) ^ multiply(a1, 13) ^ multiply(a2, 9) ^ multiply(a3, 14);
+      }
+    }
+  }
+
+  void addRoundKey(uint8_t* s, uint8_t round) {
+    for (uint8_t i = 0; i < 16; i++) s[i] ^= roundKey[16 * round + i];
+  }
+
+  uint8_t roundKey[240];
+};
+
+#endif
@@ -0,0 +1,363 @@
+#pragma once
+
+#include "QrCrypto.h"
+
+////////// QR Token //////////
+// Verifikasi lokal QR user terenkripsi dari services/aesEncryptionServiceV3.js.
+// Format token: ivHex ":" base64("Salted__" + salt[8] + ciphertext).
+//
+// Service JS memanggil CryptoJS.AES.encrypt(json, encryptionKey) dengan key
+// berupa string, sehingga CryptoJS memperlakukannya sebagai passphrase:
+//   passphrase = hex(PBKDF2-SHA256(secret, "SHINTYA_AES_SALT_2024_" + derivation, 1000, 16 byte))
+//   key[32] + iv[16] = EVP_BytesToKey(MD5, passphrase, salt)
+//   plaintext = AES-256-CBC + PKCS7
+// IV di depan ':' diabaikan oleh CryptoJS (di-override oleh KDF), jadi di sini
+// hanya divalidasi formatnya. PBKDF2 (bagian termahal) dihitung sekali di
+// begin(); per scan hanya 3 blok MD5 dan dekripsi AES.
+//
+// Skema JS tidak memiliki MAC, jadi token dianggap autentik jika padding
+// valid, payload JSON valid, email cocok dengan user terdaftar dan timestamp
+// belum kadaluarsa. Semua pembandingan memakai qrConstantTimeEquals().
+
+const uint32_t QR_TOKEN_PBKDF2_ITERATIONS = 1000;
+const uint8_t QR_TOKEN_PBKDF2_KEY_SIZE = 16;  // keySize 128 / 32 di CryptoJS
+const uint16_t QR_TOKEN_RAW_MAX = 320;        // "Salted__" + salt + ciphertext
+const uint8_t QR_TOKEN_FIELD_MAX = 64;
+const uint64_t QR_TOKEN_MAX_AGE_MS = 24ULL * 60 * 60 * 1000;  // sama dengan maxAge di JS
+const uint64_t QR_TOKEN_CLOCK_SKEW_MS = 5ULL * 60 * 1000;
+
+enum QrTokenResult : uint8_t {
+  QR_TOKEN_OK,
+  QR_TOKEN_FORMAT,   // bukan token AES V3 / base64 rusak
+  QR_TOKEN_PADDING,  // key salah atau ciphertext dimodifikasi
+  QR_TOKEN_PAYLOAD,  // JSON tidak valid atau tanpa email
+  QR_TOKEN_EXPIRED,
+};
+
+struct QrTokenPayload {
+  char email[QR_TOKEN_FIELD_MAX];
+  char name[QR_TOKEN_FIELD_MAX];
+  uint64_t timestamp;
+};
+
+// Waktu eksekusi hanya bergantung pada max, bukan pada isi/posisi selisih.
+// Setelah terminator, indeks dan byte di-mask ke 0 agar tidak membaca lewat string.
+inline bool qrConstantTimeEquals(const char* a, const char* b, size_t max) {
+  uint8_t diff = 0;
+  uint8_t endA = 0, endB = 0;
+  for (size_t i = 0; i < max; i++) {
+    uint8_t ca = (uint8_t)a[i & -(size_t)(endA ^ 1)] & (uint8_t)-(endA ^ 1);
+    uint8_t cb = (uint8_t)b[i & -(size_t)(endB ^ 1)] & (uint8_t)-(endB ^ 1);
+    diff |= ca ^ cb;
+    endA |= ca == 0;
+    endB |= cb == 0;
+  }
+  return diff == 0;
+}
+
+class QrTokenVerifier {
+public:
+  void begin(const char* secret, const char* derivation) {
+    char salt[64] = "SHINTYA_AES_SALT_2024_";
+    strncat(salt, derivation, sizeof(salt) - strlen(salt) - 1);
+
+    uint8_t key[QR_TOKEN_PBKDF2_KEY_SIZE];
+    pbkdf2Sha256((const uint8_t*)secret, strlen(secret), (const uint8_t*)salt, strlen(salt), key);
+
+    static const char hex[] = "0123456789abcdef";
+    for (uint8_t i = 0; i < QR_TOKEN_PBKDF2_KEY_SIZE; i++) {
+      passphrase[2 * i] = hex[key[i] >> 4];
+      passphrase[2 * i + 1] = hex[key[i] & 0x0f];
+    }
+    passphrase[2 * QR_TOKEN_PBKDF2_KEY_SIZE] = '\0';
+    memset(key, 0, sizeof(key));
+    ready = true;
+  }
+
+  // 32 hex IV diikuti ':'; membedakan token dari QR plaintext lama
+  static bool isToken(const char* code) {
+    for (uint8_t i = 0; i < 32; i++) {
+      if (hexValue(code[i]) < 0) return false;
+    }
+    return code[32] == ':';
+  }
+
+  // nowMs = 0 jika jam belum sinkron, pemeriksaan timestamp dilewati
+  QrTokenResult verify(const char* token, QrTokenPayload& out, uint64_t nowMs, uint64_t maxAgeMs = QR_TOKEN_MAX_AGE_MS) const {
+    memset(&out, 0, sizeof(out));
+    if (!ready || !isToken(token)) return QR_TOKEN_FORMAT;
+
+    uint8_t raw[QR_TOKEN_RAW_MAX];
+    size_t rawLen = base64Decode(token + 33, raw, sizeof(raw));
+    if (rawLen < 32 || (rawLen - 16) % 16 != 0 || memcmp(raw, "Salted__", 8) != 0) return QR_TOKEN_FORMAT;
+
+    const uint8_t* salt = raw + 8;
+    uint8_t* data = raw + 16;
+    size_t dataLen = rawLen - 16;
+
+    uint8_t derived[48];
+    evpBytesToKey(salt, derived);
+    QrAes256Cbc aes;
+    aes.setDecryptKey(derived);
+    aes.decrypt(derived + 32, data, data, dataLen);
+    memset(derived, 0, sizeof(derived));
+
+    size_t pad = pkcs7Padding(data, dataLen);
+    if (pad == 0) return QR_TOKEN_PADDING;
+
+    if (!parsePayload((const char*)data, dataLen - pad, out)) return QR_TOKEN_PAYLOAD;
+    if (nowMs != 0) {
+      if (out.timestamp > nowMs + QR_TOKEN_CLOCK_SKEW_MS || nowMs - out.timestamp > maxAgeMs) return QR_TOKEN_EXPIRED;
+    }
+    return QR_TOKEN_OK;
+  }
+
+private:
+  static int8_t hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+  }
+
+  // key <= 64 byte (secret QR), tidak perlu di-hash terlebih dahulu
+  static void hmacSha256(const uint8_t* key, size_t keyLen, const uint8_t* data, size_t dataLen, uint8_t* out) {
+    uint8_t pad[QrSha256::BLOCK];
+    uint8_t inner[QrSha256::SIZE];
+    QrSha256 sha;
+
+    memset(pad, 0x36, sizeof(pad));
+    for (size_t i = 0; i < keyLen; i++) pad[i] ^= key[i];
+    sha.begin();
+    sha.update(pad, sizeof(pad));
+    sha.update(data, dataLen);
+    sha.finish(inner);
+
+    memset(pad, 0x5c, sizeof(pad));
+    for (size_t i = 0; i < keyLen; i++) pad[i] ^= key[i];
+    sha.begin();
+    sha.update(pad, sizeof(pad));
+    sha.update(inner, sizeof(inner));
+    sha.finish(out);
+  }
+
+  // Satu blok PBKDF2 cukup karena output 16 byte < 32 byte SHA-256
+  static void pbkdf2Sha256(const uint8_t* password, size_t passwordLen, const uint8_t* salt, size_t saltLen, uint8_t* out) {
+    uint8_t block[64 + 4];
+    size_t blockLen = saltLen < 64 ? saltLen : 64;
+    memcpy(block, salt, blockLen);
+    block[blockLen] = 0;
+    block[blockLen + 1] = 0;
+    block[blockLen + 2] = 0;
+    block[blockLen + 3] = 1;
+
+    uint8_t u[QrSha256::SIZE];
+    uint8_t t[QrSha256::SIZE];
+    hmacSha256(password, passwordLen, block, blockLen + 4, u);
+    memcpy(t, u, sizeof(t));
+    for (uint32_t i = 1; i < QR_TOKEN_PBKDF2_ITERATIONS; i++) {
+      hmacSha256(password, passwordLen, u, sizeof(u), u);
+      for (uint8_t j = 0; j < sizeof(t); j++) t[j] ^= u[j];
+    }
+    memcpy(out, t, QR_TOKEN_PBKDF2_KEY_SIZE);
+  }
+
+  // OpenSSL EVP_BytesToKey (MD5, 1 iterasi) seperti CryptoJS.kdf.OpenSSL
+  void evpBytesToKey(const uint8_t* salt, uint8_t* out) const {
+    QrMd5 md5;
+    for (uint8_t offset = 0; offset < 48; offset += QrMd5::SIZE) {
+      md5.begin();
+      if (offset > 0) md5.update(out + offset - QrMd5::SIZE, QrMd5::SIZE);
+      md5.update((const uint8_t*)passphrase, 2 * QR_TOKEN_PBKDF2_KEY_SIZE);
+      md5.update(salt, 8);
+      md5.finish(out + offset);
+    }
+  }
+
+  // Mengembalikan panjang padding (1..16) atau 0 jika tidak valid, tanpa
+  // percabangan yang bergantung pada isi plaintext
+  static size_t pkcs7Padding(const uint8_t* data, size_t len) {
+    uint8_t pad = data[len - 1];
+    uint8_t bad = (uint8_t)((pad == 0) | (pad > 16));
+    for (uint8_t i = 0; i < 16; i++) {
+      uint8_t inPad = (uint8_t)-(uint8_t)(i < pad);
+      bad |= inPad & (data[len - 1 - i] ^ pad);
+    }
+    return bad ? 0 : pad;
+  }
+
+  static size_t base64Decode(const char* in, uint8_t* out, size_t max) {
+    uint32_t buffer = 0;
+    uint8_t bits = 0;
+    size_t len = 0;
+    for (; *in != '\0' && *in != '='; in++) {
+      int8_t value;
+      char c = *in;
+      if (c >= 'A' && c <= 'Z') value = c - 'A';
+      else if (c >= 'a' && c <= 'z') value = c - 'a' + 26;
+      else if (c >= '0' && c <= '9') value = c - '0' + 52;
+      else if (c == '+') value = 62;
+      else if (c == '/') value = 63;
+      else return 0;
+
+      buffer = (buffer << 6) | (uint8_t)value;
+      bits += 6;
+      if (bits >= 8) {
+        bits -= 8;
+        if (len >= max) return 0;
+        out[len++] = (uint8_t)(buffer >> bits);
+      }
+    }
+    return len;
+  }
+
+  static void skipSpace(const char*& p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) p++;
+  }
+
+  // out boleh nullptr untuk melewati string; string yang terlalu panjang gagal
+  static bool readString(const char*& p, const char* end, char* out, size_t max) {
+    if (p >= end || *p != '"') return false;
+    p++;
+    size_t len = 0;
+    while (p < end && *p != '"') {
+      uint8_t bytes[3] = { (uint8_t)*p++ };
+      uint8_t count = 1;
+      if (bytes[0] == '\\') {
+        uint32_t code;
+        if (p >= end) return false;
+        char e = *p++;
+        switch (e) {
+          case 'b': code = '\b'; break;
+          case 'f': code = '\f'; break;
+          case 'n': code = '\n'; break;
+          case 'r': code = '\r'; break;
+          case 't': code = '\t'; break;
+          case 'u':
+            code = 0;
+            for (uint8_t i = 0; i < 4; i++) {
+              int8_t v = p < end ? hexValue(*p++) : -1;
+              if (v < 0) return false;
+              code = (code << 4) | (uint8_t)v;
+            }
+            break;
+          default: code = (uint8_t)e; break;
+        }
+
+        if (code < 0x80) {
+          bytes[0] = (uint8_t)code;
+        } else if (code < 0x800) {
+          bytes[0] = (uint8_t)(0xc0 | (code >> 6));
+          bytes[1] = (uint8_t)(0x80 | (code & 0x3f));
+          count = 2;
+        } else {
+          bytes[0] = (uint8_t)(0xe0 | (code >> 12));
+          bytes[1] = (uint8_t)(0x80 | ((code >> 6) & 0x3f));
+          bytes[2] = (uint8_t)(0x80 | (code & 0x3f));
+          count = 3;
+        }
+      }
+
+      if (out != nullptr) {
+        if (len + count >= max) return false;
+        memcpy(out + len, bytes, count);
+      }
+      len += count;
+    }
+    if (p >= end) return false;
+    p++;
+    if (out != nullptr) out[len] = '\0';
+    return true;
+  }
+
+  static bool readNumber(const char*& p, const char* end, uint64_t& out) {
+    const char* start = p;
+    out = 0;
+    while (p < end && *p >= '0' && *p <= '9') out = out * 10 + (uint64_t)(*p++ - '0');
+    if (p == start) return false;
+    // Bagian pecahan/eksponen tidak dipakai untuk timestamp
+    while (p < end && (*p == '.' || *p == 'e' || *p == 'E' || *p == '+' || *p == '-' || (*p >= '0' && *p <= '9'))) p++;
+    return true;
+  }
+
+  static bool skipValue(const char*& p, const char* end) {
+    skipSpace(p, end);
+    if (p >= end) return false;
+    if (*p == '"') return readString(p, end, nullptr, 0);
+    if (*p == '{' || *p == '[') {
+      uint8_t depth = 0;
+      while (p < end) {
+        if (*p == '"') {
+          if (!readString(p, end, nullptr, 0)) return false;
+          continue;
+        }
+        if (*p == '{' || *p == '[') depth++;
+        else if (*p == '}' || *p == ']') {
+          if (--depth == 0) {
+            p++;
+            return true;
+          }
+        }
+        p++;
+      }
+      return false;
+    }
+    if (*p == '-') p++;
+    uint64_t number;
+    if (readNumber(p, end, number)) return true;
+    static const char* const literals[] = { "true", "false", "null" };
+    for (const char* literal : literals) {
+      size_t len = strlen(literal);
+      if ((size_t)(end - p) >= len && memcmp(p, literal, len) == 0) {
+        p += len;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  static bool parsePayload(const char* json, size_t len, QrTokenPayload& out) {
+    const char* p = json;
+    const char* end = json + len;
+    skipSpace(p, end);
+    if (p >= end || *p != '{') return false;
+    p++;
+
+    for (;;) {
+      skipSpace(p, end);
+      if (p < end && *p == '}') break;
+
+      // Key yang lebih panjang dari buffer pasti bukan field yang dicari
+      char key[16];
+      const char* keyStart = p;
+      if (!readString(p, end, key, sizeof(key))) {
+        p = keyStart;
+        if (!readString(p, end, nullptr, 0)) return false;
+        key[0] = '\0';
+      }
+      skipSpace(p, end);
+      if (p >= end || *p != ':') return false;
+      p++;
+      skipSpace(p, end);
+
+      bool ok;
+      if (strcmp(key, "email") == 0) ok = readString(p, end, out.email, sizeof(out.email));
+      else if (strcmp(key, "nama") == 0 || strcmp(key, "name") == 0) ok = readString(p, end, out.name, sizeof(out.name));
+      else if (strcmp(key, "timestamp") == 0) ok = readNumber(p, end, out.timestamp);
+      else ok = skipValue(p, end);
+      if (!ok) return false;
+
+      skipSpace(p, end);
+      if (p < end && *p == ',') {
+        p++;
+        continue;
+      }
+      if (p < end && *p == '}') break;
+      return false;
+    }
+    return out.email[0] != '\0';
+  }
+
+  char passphrase[2 * QR_TOKEN_PBKDF2_KEY_SIZE + 1] = "";
+  bool ready = false;
+};
@@ -0,0 +1,67 @@
+// Task tidur sampai GM67 selesai mengirim satu frame (UART RX timeout),
+// lalu membaca buffer sampai habis. Tidak ada polling saat tidak ada scan.
+void scanTask() {
+  task.setInitCoreID(0);
+  task.createTask(4096, [](void* pvParameter) {
+    scanTaskHandle = xTaskGetCurrentTaskHandle();
+    Serial1.onReceive([]() {
+      xTaskNotifyGive(scanTaskHandle);
+    }, true);
+
+    for (;;) {
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+      uint32_t start = millis();
+      do {
+        sensor.update([]() {
+          String code = sensor["code"].as<String>();
+          code.trim();
+          if (!code.isEmpty()) {
+            if (gm67ScanQueue.push(code.c_str(), SCAN_ANY, scanFlow.load(), millis(), SCAN_DEBOUNCE_MS)) {
+              xTaskNotify(loopTaskHandle, EVENT_SCAN, eSetBits);
+            }
+          }
+        });
+        delay(5);
+      } while (Serial1.available() > 0 && millis() - start < SCAN_DRAIN_MS);
+    }
+  });
+}
+
+void pushSerialScan(const String& code, ScanKind kind) {
+  serialScanQueue.push(code.c_str(), kind, scanFlow.load(), millis(), SCAN_DEBOUNCE_MS);
+}
+
+// Mengambil scan tertua yang cocok dengan kind dari kedua queue. Scan untuk
+// layar lain (RESI# saat layar QR aktif) tetap menunggu di queue.
+bool takeScan(ScanKind kind, String& out) {
+  int16_t gm67Index = gm67ScanQueue.find(kind);
+  int16_t serialIndex = serialScanQueue.find(kind);
+  if (gm67Index < 0 && serialIndex < 0) return false;
+
+  const ScanEntry* gm67Entry = gm67Index >= 0 ? gm67ScanQueue.at(gm67Index) : nullptr;
+  const ScanEntry* serialEntry = serialIndex >= 0 ? serialScanQueue.at(serialIndex) : nullptr;
+  bool fromSerial = gm67Entry == nullptr || (serialEntry != nullptr && (int32_t)(serialEntry->timestamp - gm67Entry->timestamp) < 0);
+  out = fromSerial ? serialEntry->code : gm67Entry->code;
+
+  if (fromSerial) serialScanQueue.take(serialIndex, millis());
+  else gm67ScanQueue.take(gm67Index, millis());
+  return true;
+}
+
+// Dipanggil saat flow scan selesai. Scan yang masuk selama layar diblokir
+// tetap di queue untuk user berikutnya; hanya scan ulang kode yang baru
+// diproses (masuk sebelum flow ini selesai) yang dibuang. Scan ulang setelah
+// ini mendapat flow baru dan diproses lagi.
+void clearScan(String& code) {
+  if (!code.isEmpty()) {
+    uint32_t flow = scanFlow.fetch_add(1);
+    uint8_t discarded = gm67ScanQueue.discard(code.c_str(), flow, millis());
+    discarded += serialScanQueue.discard(code.c_str(), flow, millis());
+    if (discarded > 0) {
+      Serial.print("| scan ulang dibuang: ");
+      Serial.print(discarded);
+      Serial.println();
+    }
+  }
+  code = "";
+}
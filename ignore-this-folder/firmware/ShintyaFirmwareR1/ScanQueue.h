@@ -0,0 +1,152 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+
+////////// Scan Queue //////////
+// Lock-free single-producer/single-consumer ring buffer untuk hasil scan.
+// Setiap sumber scan (GM67, perintah serial) punya queue sendiri sehingga
+// tiap queue hanya ditulis oleh satu task dan hanya dibaca oleh onLcdMenu().
+// Consumer boleh mengambil entry selain yang tertua (scan untuk layar lain
+// tetap menunggu); slot baru kembali ke producer setelah semua entry
+// sebelumnya juga diambil.
+
+const uint16_t SCAN_CODE_MAX = 480;  // cukup untuk token QR AES V3 (lihat QrToken.h)
+
+enum ScanKind : uint8_t {
+  SCAN_ANY,   // GM67, konteks ditentukan oleh menu yang aktif
+  SCAN_RESI,  // RESI#...
+  SCAN_USER,  // USER#...
+};
+
+struct ScanEntry {
+  char code[SCAN_CODE_MAX];
+  ScanKind kind;
+  uint32_t timestamp;
+  uint32_t flow;  // flow menu yang sedang berjalan saat scan masuk
+  bool taken;     // sudah diambil consumer, hanya ditulis consumer setelah push
+};
+
+struct ScanStats {
+  uint32_t pushed;
+  uint32_t duplicates;
+  uint32_t overflows;
+  uint32_t consumed;
+  uint32_t discarded;  // scan ulang kode yang sudah diproses
+  uint32_t latencyTotal;
+  uint32_t latencyMax;
+};
+
+template<uint8_t N>
+class ScanQueue {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "ScanQueue size must be a power of two");
+
+public:
+  // Producer side. Scan yang sama dalam debounceMs dianggap pembacaan ganda;
+  // jendela debounce bergeser selama kode yang sama masih terbaca.
+  bool push(const char* code, ScanKind kind, uint32_t flow, uint32_t now, uint32_t debounceMs) {
+    if (code == nullptr || code[0] == '\0') return false;
+
+    if (strncmp(code, lastCode, SCAN_CODE_MAX) == 0 && now - lastTime < debounceMs) {
+      lastTime = now;
+      stats.duplicates++;
+      return false;
+    }
+
+    // Scan yang tidak masuk queue tidak dicatat sebagai lastCode, sehingga
+    // scan ulang kode yang sama setelah overflow tetap diterima
+    uint8_t h = head.load(std::memory_order_relaxed);
+    if (static_cast<uint8_t>(h - tail.load(std::memory_order_acquire)) >= N) {
+      stats.overflows++;
+      return false;
+    }
+    strncpy(lastCode, code, SCAN_CODE_MAX - 1);
+    lastCode[SCAN_CODE_MAX - 1] = '\0';
+    lastTime = now;
+
+    ScanEntry& entry = buffer[h & (N - 1)];
+    strncpy(entry.code, code, SCAN_CODE_MAX - 1);
+    entry.code[SCAN_CODE_MAX - 1] = '\0';
+    entry.kind = kind;
+    entry.timestamp = now;
+    entry.flow = flow;
+    entry.taken = false;
+
+    head.store(static_cast<uint8_t>(h + 1), std::memory_order_release);
+    stats.pushed++;
+    return true;
+  }
+
+  // Consumer side. index 0 = entry tertua di queue; nullptr jika entry
+  // tersebut sudah diambil.
+  const ScanEntry* at(uint8_t index) const {
+    uint8_t t = tail.load(std::memory_order_relaxed);
+    if (index >= static_cast<uint8_t>(head.load(std::memory_order_acquire) - t)) return nullptr;
+    const ScanEntry& entry = buffer[static_cast<uint8_t>(t + index) & (N - 1)];
+    return entry.taken ? nullptr : &entry;
+  }
+
+  // Index entry tertua yang bisa dipakai layar kind, -1 jika tidak ada
+  int16_t find(ScanKind kind) const {
+    uint8_t count = size();
+    for (uint8_t i = 0; i < count; i++) {
+      const ScanEntry* entry = at(i);
+      if (entry != nullptr && (entry->kind == SCAN_ANY || entry->kind == kind)) return i;
+    }
+    return -1;
+  }
+
+  // discard = scan dibuang (duplikat kode yang sudah diproses), bukan dipakai menu
+  void take(uint8_t index, uint32_t now, bool discard = false) {
+    uint8_t t = tail.load(std::memory_order_relaxed);
+    uint8_t h = head.load(std::memory_order_acquire);
+    if (index >= static_cast<uint8_t>(h - t)) return;
+
+    ScanEntry& entry = buffer[static_cast<uint8_t>(t + index) & (N - 1)];
+    if (entry.taken) return;
+    entry.taken = true;
+    if (discard) {
+      stats.discarded++;
+    } else {
+      uint32_t latency = now - entry.timestamp;
+      stats.consumed++;
+      stats.latencyTotal += latency;
+      if (latency > stats.latencyMax) stats.latencyMax = latency;
+    }
+
+    while (t != h && buffer[t & (N - 1)].taken) t++;
+    tail.store(t, std::memory_order_release);
+  }
+
+  // Membuang scan ulang code yang masuk sampai flow tersebut. Dimulai dari
+  // entry terbaru: tail hanya maju jika semua entry sebelumnya sudah diambil,
+  // sehingga tidak ada entry yang belum diperiksa terlewat.
+  uint8_t discard(const char* code, uint32_t flow, uint32_t now) {
+    uint8_t discarded = 0;
+    for (uint8_t i = size(); i-- > 0;) {
+      const ScanEntry* entry = at(i);
+      if (entry != nullptr && static_cast<int32_t>(entry->flow - flow) <= 0 && strncmp(entry->code, code, SCAN_CODE_MAX) == 0) {
+        take(i, now, true);
+        discarded++;
+      }
+    }
+    return discarded;
+  }
+
+  uint8_t size() const {
+    return static_cast<uint8_t>(head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire));
+  }
+
+  const ScanStats& getStats() const {
+    return stats;
+  }
+
+private:
+  ScanEntry buffer[N];
+  std::atomic<uint8_t> head{ 0 };
+  std::atomic<uint8_t> tail{ 0 };
+
+  char lastCode[SCAN_CODE_MAX] = "";
+  uint32_t lastTime = 0;
+  ScanStats stats{};
+};
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <Arduino.h>
+
+////////// Servo Planner //////////
+// Penjadwal gerakan servo loker di channel PCA9685. Setiap servo menarik arus
+// inrush besar saat mulai bergerak lalu turun ke arus jalan, jadi gerakan baru
+// hanya dimulai jika total arus (inrush + servo yang sedang jalan) masih di
+// bawah budget. Hasilnya gerakan otomatis berselang (staggered) namun tetap
+// tumpang tindih sejauh budget mengizinkan. Posisi di-ramp dengan profil
+// smoothstep agar percepatan awal (dan arus puncaknya) lebih rendah.
+//
+// Tidak bergantung pada driver: posisi dikirim lewat ServoWriter sehingga
+// planner yang sama bisa disimulasikan tanpa hardware (lihat tests/firmware).
+
+typedef void (*ServoWriter)(uint8_t channel, uint16_t position);
+
+struct ServoPlannerConfig {
+  uint16_t budgetMa;       // arus maksimum semua servo bersamaan
+  uint16_t inrushMa;       // arus per servo selama inrushMs pertama
+  uint16_t runMa;          // arus per servo setelah inrush sampai selesai
+  uint16_t inrushMs;
+  uint16_t unitsPerSecond; // kecepatan rata-rata, satuan posisi HCPCA9685 (0..480)
+  uint16_t minMotionMs;
+};
+
+struct ServoPlannerStats {
+  uint32_t requested;
+  uint32_t coalesced;  // request ditimpa sebelum sempat dijalankan
+  uint32_t completed;
+  uint32_t waitTotal;  // waktu antri sebelum gerakan dimulai
+  uint32_t waitMax;
+  uint16_t peakLoadMa;
+  uint8_t peakConcurrent;
+  uint32_t firstStart;
+  uint32_t lastDone;
+};
+
+template<uint8_t N>
+class ServoPlanner {
+public:
+  ServoPlanner(const ServoPlannerConfig& config, ServoWriter writer, uint16_t initialPosition = 0)
+    : config(config), writer(writer) {
+    for (uint8_t i = 0; i < N; i++) {
+      channels[i].position = initialPosition;
+      channels[i].pendingTarget = initialPosition;
+    }
+  }
+
+  // Request terakhir per channel yang menang; antrian dilayani FIFO berdasarkan
+  // waktu request sehingga loker yang diminta lebih dulu bergerak lebih dulu.
+  bool request(uint8_t channel, uint16_t target, uint32_t now) {
+    if (channel >= N) return false;
+    Channel& ch = channels[channel];
+    stats.requested++;
+
+    if (ch.pending) {
+      stats.coalesced++;
+      if (target == (ch.moving ? ch.to : ch.position)) {
+        ch.pending = false;
+        return true;
+      }
+    } else {
+      if (target == (ch.moving ? ch.to : ch.position)) return true;
+      ch.requestTime = now;
+      ch.sequence = nextSequence++;
+    }
+    ch.pendingTarget = target;
+    ch.pending = true;
+    return true;
+  }
+
+  // Dipanggil periodik (~20 ms, satu frame PWM servo).
+  void update(uint32_t now) {
+    uint8_t concurrent = 0;
+    for (uint8_t i = 0; i < N; i++) {
+      Channel& ch = channels[i];
+      if (!ch.moving) continue;
+
+      uint32_t elapsed = now - ch.startTime;
+      if (elapsed >= ch.duration) {
+        ch.position = ch.to;
+        ch.moving = false;
+        write(i, ch.position);
+        stats.completed++;
+        stats.lastDone = now;
+        continue;
+      }
+      ch.position = interpolate(ch, elapsed);
+      write(i, ch.position);
+      concurrent++;
+    }
+
+    uint16_t load = currentLoad(now);
+    int8_t next;
+    while ((next = nextPending()) >= 0) {
+      // Budget lebih kecil dari inrush satu servo: tetap jalan, satu per satu
+      if (load + config.inrushMa > config.budgetMa && concurrent > 0) break;
+
+      start(next, now);
+      load += config.inrushMa;
+      concurrent++;
+    }
+
+    if (load > stats.peakLoadMa) stats.peakLoadMa = load;
+    if (concurrent > stats.peakConcurrent) stats.peakConcurrent = concurrent;
+  }
+
+  uint16_t currentLoad(uint32_t now) const {
+    uint16_t load = 0;
+    for (uint8_t i = 0; i < N; i++) {
+      if (!channels[i].moving) continue;
+      load += now - channels[i].startTime < config.inrushMs ? config.inrushMa : config.runMa;
+    }
+    return load;
+  }
+
+  bool isSettled(uint8_t channel) const {
+    return channel >= N || (!channels[channel].moving && !channels[channel].pending);
+  }
+
+  bool isIdle() const {
+    for (uint8_t i = 0; i < N; i++) {
+      if (!isSettled(i)) return false;
+    }
+    return true;
+  }
+
+  uint16_t getPosition(uint8_t channel) const {
+    return channel < N ? channels[channel].position : 0;
+  }
+
+  uint32_t motionTime(uint16_t from, uint16_t to) const {
+    uint32_t distance = from > to ? from - to : to - from;
+    uint32_t duration = config.unitsPerSecond ? distance * 1000 / config.unitsPerSecond : 0;
+    return duration < config.minMotionMs ? config.minMotionMs : duration;
+  }
+
+  const ServoPlannerStats& getStats() const {
+    return stats;
+  }
+
+private:
+  struct Channel {
+    uint16_t position;
+    uint16_t from;
+    uint16_t to;
+    uint16_t pendingTarget;
+    uint32_t startTime;
+    uint32_t duration;
+    uint32_t requestTime;
+    uint32_t sequence;
+    bool moving;
+    bool pending;
+  };
+
+  int8_t nextPending() const {
+    int8_t next = -1;
+    for (uint8_t i = 0; i < N; i++) {
+      const Channel& ch = channels[i];
+      if (!ch.pending || ch.moving) continue;
+      if (next < 0 || (int32_t)(ch.sequence - channels[next].sequence) < 0) next = i;
+    }
+    return next;
+  }
+
+  void start(uint8_t channel, uint32_t now) {
+    Channel& ch = channels[channel];
+    ch.from = ch.position;
+    ch.to = ch.pendingTarget;
+    ch.startTime = now;
+    ch.duration = motionTime(ch.from, ch.to);
+    ch.moving = true;
+    ch.pending = false;
+
+    uint32_t wait = now - ch.requestTime;
+    stats.waitTotal += wait;
+    if (wait > stats.waitMax) stats.waitMax = wait;
+    if (!started) stats.firstStart = now;
+    started = true;
+  }
+
+  // Smoothstep 3t^2 - 2t^3 dalam fixed point (t dalam 1/1024)
+  uint16_t interpolate(const Channel& ch, uint32_t elapsed) const {
+    uint32_t t = elapsed * 1024 / ch.duration;
+    uint32_t s = (3 * 1024 - 2 * t) * t / 1024 * t / 1024;
+    int32_t delta = (int32_t)ch.to - (int32_t)ch.from;
+    return (uint16_t)(ch.from + delta * (int32_t)s / 1024);
+  }
+
+  void write(uint8_t channel, uint16_t position) {
+    if (writer != nullptr) writer(channel, position);
+  }
+
+  ServoPlannerConfig config;
+  ServoWriter writer;
+  Channel channels[N]{};
+  uint32_t nextSequence = 0;
+  bool started = false;
+  ServoPlannerStats stats{};
+};
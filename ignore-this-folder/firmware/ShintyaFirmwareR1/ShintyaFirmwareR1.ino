@@ -2,6 +2,8 @@
 
 void setup() {
   usbSerial.begin(&Serial, 115200);
+  restoreTableCache();
+  initializeQRVerifier();
   task.initialize(wifiTask);
 
   menu.initialize(true);
@@ -36,7 +38,6 @@ void setup() {
   servoDriver.Sleep(false);
 #endif
 
-  sensor.addModule("sonar", new UltrasonicSens(14, 27));
   sensor.addModule("code", new GM67Sens(&Serial1, 9600, SERIAL_8N1, 26, 25));
 #if JUST_TESTING
   sensor.addModule("keypad", []() -> BaseSens* {
@@ -53,13 +54,17 @@ void setup() {
   });
 #endif
   sensor.init();
+  initializeInputEvents();
+  lokerTask();
+  scanTask();
   buzzer.toggleInit(100, 5);
 }
 
 void loop() {
-  sensor.update([]() {
-    // sensor.debug();
-  });
+  waitForInputEvents(LOOP_IDLE_TIMEOUT_MS);
+  DigitalIn::updateAll(&buttonDown, &buttonOk, DigitalIn::stop());
+  if (buttonDown.isPressed()) buttonDownStr = "D";
+  if (buttonOk.isPressed()) buttonOkStr = "S";
   usbSerial.receive(usbCommunicationTask);
 
   MenuCursor cursor{
@@ -73,10 +78,4 @@ void loop() {
 
   buttonDownStr = "";
   buttonOkStr = "";
-
-  DigitalIn::updateAll(&buttonDown, &buttonOk, DigitalIn::stop());
-  DigitalOut::updateAll(&buzzer, &ledRed, &ledGreen, &ledYellow, &relayA, &relayB, DigitalOut::stop());
-#if JUST_TESTING
-  PCF8574DigitalIn::updateAll(&limitSwitch1, &limitSwitch2, &limitSwitch3, &limitSwitch4, &limitSwitch5, &limitSwitch6, &limitSwitch7, &limitSwitch8, &limitSwitch9, &limitSwitch10, &limitSwitch11, &limitSwitch12, PCF8574DigitalIn::stop());
-#endif
 }
@@ -15,8 +15,8 @@ void usbCommunicationTask(const String& dataRecv) {
     if (dataHeader == "D") buttonDownStr = "D";
     if (dataHeader == "S") buttonOkStr = "S";
 
-    if (dataHeader == "RESI") resiBarcode = dataValue;  // RESI#111
-    if (dataHeader == "USER") userQRCode = dataValue;   // USER#admin
+    if (dataHeader == "RESI") pushSerialScan(dataValue, SCAN_RESI);  // RESI#111
+    if (dataHeader == "USER") pushSerialScan(dataValue, SCAN_USER);  // USER#admin
 
     // Firebase RTDB
     if (dataHeader == "RTDB_SET_VALUE") firebaseRTDBState = RTDB_SET_VALUE;
@@ -0,0 +1,50 @@
+void initializeQRVerifier() {
+  uint32_t start = micros();
+  userQRVerifier.begin(QR_USER_SECRET, QR_USER_DERIVATION);
+  Serial.print("| qr verifier ready: ");
+  Serial.print(micros() - start);
+  Serial.print(" us");
+  Serial.println();
+}
+
+const char* qrTokenResultString(QrTokenResult result) {
+  switch (result) {
+    case QR_TOKEN_OK: return "ok";
+    case QR_TOKEN_FORMAT: return "format";
+    case QR_TOKEN_PADDING: return "padding";
+    case QR_TOKEN_PAYLOAD: return "payload";
+    case QR_TOKEN_EXPIRED: return "expired";
+  }
+  return "unknown";
+}
+
+// Mengembalikan index userData pemilik QR atau -1. Semua user dibandingkan
+// tanpa berhenti di kecocokan pertama agar waktu tidak membocorkan posisi.
+int findUserByQR(const String& code) {
+  int found = -1;
+
+  if (QrTokenVerifier::isToken(code.c_str())) {
+    time_t now = time(nullptr);
+    uint64_t nowMs = now >= QR_MIN_VALID_EPOCH ? (uint64_t)now * 1000 : 0;
+
+    QrTokenPayload payload;
+    QrTokenResult result = userQRVerifier.verify(code.c_str(), payload, nowMs);
+    if (result == QR_TOKEN_OK) {
+      for (int i = 0; i < USER_MAX; i++) {
+        bool match = !userData[i].email.isEmpty() & qrConstantTimeEquals(payload.email, userData[i].email.c_str(), QR_TOKEN_FIELD_MAX);
+        if (match && found < 0) found = i;
+      }
+    } else {
+      Serial.print("| qr token ditolak: ");
+      Serial.print(qrTokenResultString(result));
+      Serial.println();
+    }
+  } else if (QR_ALLOW_PLAINTEXT) {
+    for (int i = 0; i < USER_MAX; i++) {
+      bool match = !userData[i].name.isEmpty() & qrConstantTimeEquals(code.c_str(), userData[i].name.c_str(), SCAN_CODE_MAX);
+      if (match && found < 0) found = i;
+    }
+  }
+
+  return found;
+}
@@ -22,6 +22,8 @@ void wifiTask() {
     if (!dateTime.begin()) {
       Serial.println("Gagal memulai NTP Client!");
     }
+    // Jam sistem untuk time(nullptr), dipakai cek kadaluarsa QR di findUserByQR
+    configTime(gmtOffset_sec, daylightOffset_sec, ntpServer);
 
     FirebaseV3Application::getInstance()->setTime(dateTime.now());
     if (!FirebaseV3Application::getInstance()->begin(FIREBASE_CLIENT_EMAIL, FIREBASE_PROJECT_ID, FIREBASE_PRIVATE_KEY)) {
@@ -74,31 +76,13 @@ void wifiTask() {
         String userDataResultStr = firestore->getDocument("users", "", true);
         String resiDataResultStr = firestore->getDocument("resiData", "", true);
 
-        JsonDocument userDataDocument;
-        JsonDocument resiDataDocument;
-        deserializeJson(userDataDocument, userDataResultStr);
-        deserializeJson(resiDataDocument, resiDataResultStr);
-
-        uint8_t userDataIndex = 0;
-        uint8_t resiDataIndex = 0;
-
-        for (JsonVariant fields : userDataDocument["documents"].as<JsonArray>()) {
-          if (userDataIndex < USER_MAX) {
-            userData[userDataIndex].displayName = fields["fields"]["displayName"]["stringValue"].as<String>();
-            userData[userDataIndex].name = fields["fields"]["name"]["stringValue"].as<String>();
-            userData[userDataIndex].email = fields["fields"]["email"]["stringValue"].as<String>();
-            userDataIndex++;
-          }
+        // Fetch gagal tidak menimpa tabel maupun cache; koleksi kosong tetap disimpan
+        size_t userCount, resiCount;
+        if (firestoreDecodeTable(userDataResultStr, userData, USER_MAX, userCount)) {
+          writeTableCache("users", firestoreEncodeDocuments(userData, userCount));
         }
-
-        for (JsonVariant fields : resiDataDocument["documents"].as<JsonArray>()) {
-          if (resiDataIndex < PAKET_MAX) {
-            resiData[resiDataIndex].nama = fields["fields"]["nama"]["stringValue"].as<String>();
-            resiData[resiDataIndex].noResi = fields["fields"]["noResi"]["stringValue"].as<String>();
-            resiData[resiDataIndex].packetType = fields["fields"]["packetType"]["stringValue"].as<String>();
-            resiData[resiDataIndex].resiId = fields["fields"]["resiId"]["integerValue"].as<int>();
-            resiDataIndex++;
-          }
+        if (firestoreDecodeTable(resiDataResultStr, resiData, PAKET_MAX, resiCount)) {
+          writeTableCache("resi", firestoreEncodeDocuments(resiData, resiCount));
         }
       }
       
@@ -32,13 +32,19 @@ import {
   setDoc, 
   getDoc,
   updateDoc,
+  getDocs,
+  query,
+  orderBy,
+  limit,
   serverTimestamp 
 } from 'firebase/firestore';
 import { db } from './firebase';
+import { decodeCapacityHistory } from '../utils/capacityHistoryDecoder';
 
 // Konstanta konfigurasi Firebase untuk data sensor kapasitas
 const CAPACITY_COLLECTION = 'capacity';
 const CAPACITY_DOC_ID = 'box_sensor';
+const CAPACITY_HISTORY_COLLECTION = 'history';
 
 /**
  * Mengambil data kapasitas terkini dari sensor ultrasonik ESP32.
@@ -350,4 +356,58 @@ export const calculateCapacityStatus = (height, maxHeight = 30) => {
     message,
     color
   };
-};
\ No newline at end of file
+};
+
+// Decoder tetap diekspor dari service ini seperti sebelumnya
+export { decodeCapacityHistory };
+
+/**
+ * Mengambil riwayat ketinggian paket (time series) dari ESP32.
+ * 
+ * Menggabungkan beberapa dokumen batch terbaru dari subcollection
+ * capacity/box_sensor/history dan mengembalikan sampel yang sudah
+ * di-decode, diurutkan berdasarkan waktu (epoch ms).
+ * 
+ * @async
+ * @function getCapacityHistory
+ * @param {number} [batchLimit=60] - Jumlah dokumen batch terbaru yang diambil
+ * @returns {Promise<Object>} Response object dengan format:
+ *   - success: boolean - Status keberhasilan operasi
+ *   - data: Array<Object> - Sampel { time, height }
+ *   - error: string - Pesan error jika operasi gagal
+ * 
+ * @example
+ * const result = await getCapacityHistory(10);
+ * if (result.success) {
+ *   drawFillCurve(result.data);
+ * }
+ */
+export const getCapacityHistory = async (batchLimit = 60) => {
+  try {
+    const historyRef = collection(db, CAPACITY_COLLECTION, CAPACITY_DOC_ID, CAPACITY_HISTORY_COLLECTION);
+    const historyQuery = query(historyRef, orderBy('firstSampleTime', 'desc'), limit(batchLimit));
+    const snapshot = await getDocs(historyQuery);
+
+    const samples = [];
+    snapshot.forEach((docSnap) => {
+      try {
+        samples.push(...decodeCapacityHistory(docSnap.data()));
+      } catch (decodeError) {
+        console.warn('Skipping capacity history batch:', docSnap.id, decodeError.message);
+      }
+    });
+    // time dalam epoch ms sehingga batch dari boot berbeda bisa digabung
+    samples.sort((a, b) => a.time - b.time);
+
+    return {
+      success: true,
+      data: samples
+    };
+  } catch (error) {
+    console.error('Error getting capacity history:', error);
+    return {
+      success: false,
+      error: error.message
+    };
+  }
+};
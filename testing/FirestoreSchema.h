@@ -0,0 +1,593 @@
+#pragma once
+
+#include <Arduino.h>
+#include <type_traits>
+
+////////// Firestore Schema //////////
+// Mapping struct <-> dokumen Firestore (typed value) yang dideklarasikan sekali
+// per struct. Encoder menulis JSON langsung ke String dan decoder membaca
+// response REST secara streaming langsung ke field struct, tanpa JsonDocument.
+//
+// Deklarasi schema:
+//   template<> struct FirestoreSchema<ResiData> {
+//     template<typename V, typename D> static void fields(V& v, D& d) {
+//       v("noResi", d.noResi);
+//       v("resiId", d.resiId);
+//     }
+//   };
+//
+// Tipe field: String -> stringValue, integer (int8_t .. uint64_t) -> integerValue,
+// float/double -> doubleValue, bool -> booleanValue,
+// FirestoreTimestamp -> timestampValue, struct dengan FirestoreSchema -> mapValue.
+
+template<typename T>
+struct FirestoreSchema;
+
+// Waktu dalam epoch ms, dikirim sebagai timestampValue (RFC 3339, UTC) agar
+// app membacanya sebagai Timestamp seperti serverTimestamp(). 0 berarti jam
+// device belum diset dan ditulis sebagai nullValue.
+struct FirestoreTimestamp {
+  long long epochMs = 0;
+
+  // "2026-10-18T05:00:00.123Z", buffer 48 byte cukup untuk tahun berapa pun
+  void format(char* out, size_t size) const {
+    long long seconds = epochMs / 1000;
+    int millis = (int)(epochMs % 1000);
+    if (millis < 0) {
+      millis += 1000;
+      seconds--;
+    }
+    long long days = seconds / 86400;
+    long long rest = seconds % 86400;
+    if (rest < 0) {
+      rest += 86400;
+      days--;
+    }
+    int year;
+    unsigned month, day;
+    civilFromDays(days, year, month, day);
+    snprintf(out, size, "%04d-%02u-%02uT%02d:%02d:%02d.%03dZ", year, month, day,
+             (int)(rest / 3600), (int)(rest / 60 % 60), (int)(rest % 60), millis);
+  }
+
+  // Menerima pecahan detik dan offset (Z, +07:00) seperti yang dikirim Firestore
+  bool parse(const char* text) {
+    int year, month, day, hour, minute, second;
+    int length = 0;
+    if (sscanf(text, "%4d-%2d-%2dT%2d:%2d:%2d%n", &year, &month, &day, &hour, &minute, &second, &length) != 6) return false;
+    const char* p = text + length;
+    int millis = 0;
+    if (*p == '.') {
+      int scale = 100;
+      for (p++; isdigit((uint8_t)*p); p++) {
+        millis += (*p - '0') * scale;
+        scale /= 10;
+      }
+    }
+    long long offset = 0;
+    if (*p == '+' || *p == '-') {
+      int offsetHour, offsetMinute;
+      if (sscanf(p + 1, "%2d:%2d", &offsetHour, &offsetMinute) != 2) return false;
+      offset = (offsetHour * 60 + offsetMinute) * 60LL * (*p == '-' ? -1 : 1);
+    } else if (*p != 'Z' && *p != 'z') {
+      return false;
+    }
+    long long seconds = daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second - offset;
+    epochMs = seconds * 1000 + millis;
+    return true;
+  }
+
+  // Kalender Gregorian proleptik <-> hari sejak 1970-01-01
+  static long long daysFromCivil(int year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    long long era = (year >= 0 ? year : year - 399) / 400;
+    unsigned yearOfEra = (unsigned)(year - era * 400);
+    unsigned dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + (long long)dayOfEra - 719468;
+  }
+
+  static void civilFromDays(long long days, int& year, unsigned& month, unsigned& day) {
+    days += 719468;
+    long long era = (days >= 0 ? days : days - 146096) / 146097;
+    unsigned dayOfEra = (unsigned)(days - era * 146097);
+    unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    unsigned monthIndex = (5 * dayOfYear + 2) / 153;
+    day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+    month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+    year = (int)(yearOfEra + era * 400) + (month <= 2);
+  }
+};
+
+////////// Encoder //////////
+
+class FirestoreEncoder {
+public:
+  explicit FirestoreEncoder(String& out)
+    : out(out), first(true) {}
+
+  template<typename M>
+  void operator()(const char* name, const M& member) {
+    if (!first) out += ',';
+    first = false;
+    writeString(name);
+    out += ':';
+    writeValue(member);
+  }
+
+  template<typename T>
+  void writeFields(const T& obj) {
+    out += "{\"fields\":{";
+    FirestoreEncoder nested(out);
+    FirestoreSchema<T>::fields(nested, obj);
+    out += "}}";
+  }
+
+private:
+  String& out;
+  bool first;
+
+  void writeValue(const String& value) {
+    out += "{\"stringValue\":";
+    writeString(value.c_str());
+    out += '}';
+  }
+  void writeValue(const char* value) {
+    out += "{\"stringValue\":";
+    writeString(value);
+    out += '}';
+  }
+  void writeValue(bool value) {
+    out += value ? "{\"booleanValue\":true}" : "{\"booleanValue\":false}";
+  }
+  void writeValue(signed char value) { writeInteger((long long)value); }
+  void writeValue(unsigned char value) { writeInteger((unsigned long long)value); }
+  void writeValue(short value) { writeInteger((long long)value); }
+  void writeValue(unsigned short value) { writeInteger((unsigned long long)value); }
+  void writeValue(int value) { writeInteger(value); }
+  void writeValue(long value) { writeInteger(value); }
+  void writeValue(long long value) { writeInteger(value); }
+  void writeValue(unsigned int value) { writeInteger(value); }
+  void writeValue(unsigned long value) { writeInteger(value); }
+  void writeValue(unsigned long long value) { writeInteger(value); }
+  void writeValue(float value) { writeDouble(value); }
+  void writeValue(double value) { writeDouble(value); }
+
+  void writeValue(const FirestoreTimestamp& value) {
+    if (value.epochMs == 0) {
+      out += "{\"nullValue\":null}";
+      return;
+    }
+    char buffer[48];
+    value.format(buffer, sizeof(buffer));
+    out += "{\"timestampValue\":\"";
+    out += buffer;
+    out += "\"}";
+  }
+
+  template<typename T>
+  void writeValue(const T& nested) {
+    static_assert(std::is_class<T>::value, "FirestoreSchema: tipe field tidak didukung");
+    out += "{\"mapValue\":";
+    writeFields(nested);
+    out += '}';
+  }
+
+  void writeInteger(long long value) {
+    char buffer[48];
+    snprintf(buffer, sizeof(buffer), "{\"integerValue\":\"%lld\"}", value);
+    out += buffer;
+  }
+  void writeInteger(unsigned long long value) {
+    char buffer[48];
+    snprintf(buffer, sizeof(buffer), "{\"integerValue\":\"%llu\"}", value);
+    out += buffer;
+  }
+  void writeInteger(int value) { writeInteger((long long)value); }
+  void writeInteger(long value) { writeInteger((long long)value); }
+  void writeInteger(unsigned int value) { writeInteger((unsigned long long)value); }
+  void writeInteger(unsigned long value) { writeInteger((unsigned long long)value); }
+
+  void writeDouble(double value) {
+    char buffer[40];
+    snprintf(buffer, sizeof(buffer), "{\"doubleValue\":%.7g}", value);
+    out += buffer;
+  }
+
+  void writeString(const char* value) {
+    out += '"';
+    for (const char* c = value; *c; c++) {
+      switch (*c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+          if ((uint8_t)*c < 0x20) {
+            char buffer[8];
+            snprintf(buffer, sizeof(buffer), "\\u%04x", (uint8_t)*c);
+            out += buffer;
+          } else {
+            out += *c;
+          }
+      }
+    }
+    out += '"';
+  }
+};
+
+template<typename T>
+String firestoreEncode(const T& obj) {
+  String out;
+  out.reserve(128);
+  FirestoreEncoder(out).writeFields(obj);
+  return out;
+}
+
+// Format yang sama dengan response collection, bisa dibaca firestoreDecodeDocuments()
+template<typename T>
+String firestoreEncodeDocuments(const T* items, size_t count) {
+  String out;
+  out.reserve(32 + count * 128);
+  out += "{\"documents\":[";
+  for (size_t i = 0; i < count; i++) {
+    if (i > 0) out += ',';
+    FirestoreEncoder(out).writeFields(items[i]);
+  }
+  out += "]}";
+  return out;
+}
+
+////////// Decoder //////////
+
+class FirestoreReader {
+public:
+  FirestoreReader(const char* data, size_t length)
+    : p(data), end(data + length), error(false) {}
+
+  bool hasError() const {
+    return error;
+  }
+
+  // Response getDocument() untuk collection: {"documents":[{"fields":{...}}, ...]}
+  // Koleksi kosong dikirim sebagai {}, response {"error":{...}} dianggap gagal.
+  template<typename T>
+  size_t readDocuments(T* out, size_t max) {
+    size_t count = 0;
+    if (!enterObject()) return 0;
+    char key[32];
+    while (nextKey(key, sizeof(key))) {
+      if (strcmp(key, "error") == 0) {
+        fail();
+        return 0;
+      }
+      if (strcmp(key, "documents") != 0) {
+        skipValue();
+        continue;
+      }
+      if (!enterArray()) return count;
+      while (nextElement()) {
+        if (count < max) {
+          out[count] = T();
+          if (readDocument(out[count])) count++;
+        } else {
+          skipValue();
+        }
+      }
+    }
+    return count;
+  }
+
+  // Satu dokumen: {"name":"...","fields":{...},"createTime":"..."}
+  template<typename T>
+  bool readDocument(T& obj) {
+    if (!enterObject()) return false;
+    char key[32];
+    while (nextKey(key, sizeof(key))) {
+      if (strcmp(key, "fields") == 0) readFields(obj);
+      else skipValue();
+    }
+    return !error;
+  }
+
+  template<typename T>
+  void readFields(T& obj) {
+    if (!enterObject()) return;
+    char key[48];
+    while (nextKey(key, sizeof(key))) {
+      FieldMatcher matcher(*this, key);
+      FirestoreSchema<T>::fields(matcher, obj);
+      if (!matcher.matched) skipValue();
+    }
+  }
+
+private:
+  const char* p;
+  const char* end;
+  bool error;
+
+  struct FieldMatcher {
+    FirestoreReader& reader;
+    const char* key;
+    bool matched;
+
+    FieldMatcher(FirestoreReader& reader, const char* key)
+      : reader(reader), key(key), matched(false) {}
+
+    template<typename M>
+    void operator()(const char* name, M& member) {
+      if (!matched && strcmp(name, key) == 0) {
+        matched = true;
+        reader.readTypedValue(member);
+      }
+    }
+  };
+
+  template<typename M>
+  void readTypedValue(M& member) {
+    if (!enterObject()) return;
+    char type[16];
+    while (nextKey(type, sizeof(type))) {
+      if (!readValue(type, member)) skipValue();
+    }
+  }
+
+  bool readValue(const char* type, String& value) {
+    if (strcmp(type, "stringValue") != 0) return false;
+    value = "";
+    return readString(value);
+  }
+  bool readValue(const char* type, bool& value) {
+    if (strcmp(type, "booleanValue") != 0) return false;
+    skipWhitespace();
+    value = p < end && *p == 't';
+    return skipValue();
+  }
+  bool readValue(const char* type, signed char& value) { return readInteger(type, value); }
+  bool readValue(const char* type, unsigned char& value) { return readInteger(type, value); }
+  bool readValue(const char* type, short& value) { return readInteger(type, value); }
+  bool readValue(const char* type, unsigned short& value) { return readInteger(type, value); }
+  bool readValue(const char* type, int& value) { return readInteger(type, value); }
+  bool readValue(const char* type, unsigned int& value) { return readInteger(type, value); }
+  bool readValue(const char* type, long& value) { return readInteger(type, value); }
+  bool readValue(const char* type, unsigned long& value) { return readInteger(type, value); }
+  bool readValue(const char* type, long long& value) { return readInteger(type, value); }
+  bool readValue(const char* type, unsigned long long& value) { return readInteger(type, value); }
+  bool readValue(const char* type, float& value) {
+    double number;
+    if (!readNumber(type, number)) return false;
+    value = (float)number;
+    return true;
+  }
+  bool readValue(const char* type, double& value) {
+    return readNumber(type, value);
+  }
+  bool readValue(const char* type, FirestoreTimestamp& value) {
+    if (strcmp(type, "nullValue") == 0) {
+      value.epochMs = 0;
+      return skipValue();
+    }
+    if (strcmp(type, "timestampValue") != 0) return false;
+    String text;
+    if (!readString(text)) return false;
+    if (!value.parse(text.c_str())) value.epochMs = 0;
+    return true;
+  }
+
+  template<typename T>
+  bool readValue(const char* type, T& nested) {
+    static_assert(std::is_class<T>::value, "FirestoreSchema: tipe field tidak didukung");
+    if (strcmp(type, "mapValue") != 0) return false;
+    if (!enterObject()) return true;
+    char key[16];
+    while (nextKey(key, sizeof(key))) {
+      if (strcmp(key, "fields") == 0) readFields(nested);
+      else skipValue();
+    }
+    return true;
+  }
+
+  template<typename I>
+  bool readInteger(const char* type, I& value) {
+    long long number;
+    if (!readNumber(type, number)) return false;
+    value = (I)number;
+    return true;
+  }
+
+  // integerValue dikirim sebagai string, doubleValue sebagai number.
+  template<typename N>
+  bool readNumber(const char* type, N& value) {
+    bool isInteger = strcmp(type, "integerValue") == 0;
+    if (!isInteger && strcmp(type, "doubleValue") != 0) return false;
+    skipWhitespace();
+    bool quoted = p < end && *p == '"';
+    if (quoted) p++;
+    char buffer[32];
+    size_t length = 0;
+    while (p < end && length < sizeof(buffer) - 1 && (isdigit((uint8_t)*p) || *p == '-' || *p == '+' || *p == '.' || *p == 'e' || *p == 'E')) {
+      buffer[length++] = *p++;
+    }
+    buffer[length] = '\0';
+    if (quoted) {
+      while (p < end && *p != '"') p++;
+      if (p >= end) return fail();
+      p++;
+    }
+    value = isInteger ? (N)strtoll(buffer, nullptr, 10) : (N)strtod(buffer, nullptr);
+    return true;
+  }
+
+  bool fail() {
+    error = true;
+    p = end;
+    return false;
+  }
+
+  void skipWhitespace() {
+    while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) p++;
+  }
+
+  bool enterObject() {
+    skipWhitespace();
+    if (p >= end || *p != '{') return fail();
+    p++;
+    return true;
+  }
+
+  bool enterArray() {
+    skipWhitespace();
+    if (p >= end || *p != '[') return fail();
+    p++;
+    return true;
+  }
+
+  // Maju ke key berikutnya pada object yang sedang dibaca.
+  // Pembacaan value (termasuk nested) harus selesai sebelum nextKey() dipanggil lagi.
+  bool nextKey(char* key, size_t size) {
+    if (!nextItem('}')) return false;
+    if (!readKey(key, size)) return false;
+    skipWhitespace();
+    if (p >= end || *p != ':') return fail();
+    p++;
+    return true;
+  }
+
+  bool nextElement() {
+    return nextItem(']');
+  }
+
+  bool nextItem(char close) {
+    skipWhitespace();
+    if (p >= end) return fail();
+    if (*p == close) {
+      p++;
+      return false;
+    }
+    if (*p == ',') {
+      p++;
+      skipWhitespace();
+    }
+    return p < end;
+  }
+
+  bool readKey(char* key, size_t size) {
+    if (p >= end || *p != '"') return fail();
+    p++;
+    size_t length = 0;
+    while (p < end && *p != '"') {
+      if (*p == '\\') p++;
+      if (p < end && length < size - 1) key[length++] = *p;
+      p++;
+    }
+    key[length] = '\0';
+    if (p >= end) return fail();
+    p++;
+    return true;
+  }
+
+  bool readString(String& out) {
+    skipWhitespace();
+    if (p >= end || *p != '"') return fail();
+    p++;
+    const char* run = p;
+    while (p < end && *p != '"') {
+      if (*p != '\\') {
+        p++;
+        continue;
+      }
+      out.concat(run, p - run);
+      if (++p >= end) return fail();
+      switch (*p) {
+        case 'n': out += '\n'; break;
+        case 'r': out += '\r'; break;
+        case 't': out += '\t'; break;
+        case 'b': out += '\b'; break;
+        case 'f': out += '\f'; break;
+        case 'u': {
+          if (end - p < 5) return fail();
+          char hex[5] = { p[1], p[2], p[3], p[4], '\0' };
+          uint32_t code = strtoul(hex, nullptr, 16);
+          if (code < 0x80) {
+            out += (char)code;
+          } else if (code < 0x800) {
+            out += (char)(0xC0 | (code >> 6));
+            out += (char)(0x80 | (code & 0x3F));
+          } else {
+            out += (char)(0xE0 | (code >> 12));
+            out += (char)(0x80 | ((code >> 6) & 0x3F));
+            out += (char)(0x80 | (code & 0x3F));
+          }
+          p += 4;
+          break;
+        }
+        default: out += *p; break;
+      }
+      run = ++p;
+    }
+    if (p >= end) return fail();
+    out.concat(run, p - run);
+    p++;
+    return true;
+  }
+
+  bool skipValue() {
+    skipWhitespace();
+    if (p >= end) return fail();
+    if (*p == '"') {
+      p++;
+      while (p < end && *p != '"') {
+        if (*p == '\\') p++;
+        p++;
+      }
+      if (p >= end) return fail();
+      p++;
+      return true;
+    }
+    if (*p == '{' || *p == '[') {
+      int depth = 0;
+      while (p < end) {
+        if (*p == '"') {
+          skipValue();
+          continue;
+        }
+        if (*p == '{' || *p == '[') depth++;
+        if (*p == '}' || *p == ']') depth--;
+        p++;
+        if (depth == 0) return true;
+      }
+      return fail();
+    }
+    while (p < end && *p != ',' && *p != '}' && *p != ']') p++;
+    return true;
+  }
+};
+
+template<typename T>
+size_t firestoreDecodeDocuments(const String& json, T* out, size_t max) {
+  FirestoreReader reader(json.c_str(), json.length());
+  return reader.readDocuments(out, max);
+}
+
+// Mengganti seluruh isi tabel dengan dokumen dari response collection.
+// Response kosong/rusak (fetch gagal) mengembalikan false tanpa mengubah
+// tabel; koleksi kosong valid dan mengosongkan tabel.
+template<typename T>
+bool firestoreDecodeTable(const String& json, T* table, size_t max, size_t& count) {
+  FirestoreReader check(json.c_str(), json.length());
+  check.readDocuments(table, 0);
+  if (check.hasError()) return false;
+
+  for (size_t i = 0; i < max; i++) table[i] = T();
+  FirestoreReader reader(json.c_str(), json.length());
+  count = reader.readDocuments(table, max);
+  return !reader.hasError();
+}
+
+template<typename T>
+bool firestoreDecodeDocument(const String& json, T& obj) {
+  FirestoreReader reader(json.c_str(), json.length());
+  return reader.readDocument(obj);
+}
@@ -0,0 +1,102 @@
+#!/usr/bin/env node
+
+/**
+ * CAPACITY HISTORY TEST - Decoder riwayat kapasitas ESP32
+ * 
+ * Memastikan decodeCapacityHistory membaca format batch yang ditulis
+ * testing/esp32-framework.cpp (uploadCapacityTelemetry): waktu epoch ms,
+ * sampel dengan gap, dan beberapa chunk dalam satu batch.
+ * 
+ * Usage:
+ * ```bash
+ * node tests/capacityHistory.test.js
+ * npm run test-encryption
+ * ```
+ * 
+ * @author Shintya Package Delivery System
+ * @version 1.0.0
+ */
+
+import { decodeCapacityHistory, CAPACITY_HISTORY_ENCODING } from '../utils/capacityHistoryDecoder.js';
+
+console.log('📦 Capacity History Decoder Test');
+console.log(''.padEnd(60, '='));
+
+const assert = (condition, message) => {
+  if (!condition) throw new Error(message);
+  console.log(`✅ ${message}`);
+};
+
+// Encoder dengan layout yang sama seperti firmware
+const writeVarint = (out, value) => {
+  while (value >= 0x80) {
+    out.push((value % 0x80) | 0x80);
+    value = Math.floor(value / 0x80);
+  }
+  out.push(value);
+};
+const zigzag = (value) => (value >= 0 ? value * 2 : -value * 2 - 1);
+
+const encodeChunk = (out, { epochStart, interval, samples }) => {
+  const data = [];
+  samples.forEach(({ mm, gap }, i) => {
+    if (i === 0) {
+      writeVarint(data, zigzag(mm));
+      return;
+    }
+    writeVarint(data, zigzag(mm - samples[i - 1].mm) * 2 + (gap ? 1 : 0));
+    if (gap) writeVarint(data, gap);
+  });
+  writeVarint(out, epochStart);
+  writeVarint(out, interval);
+  writeVarint(out, samples.length);
+  writeVarint(out, data.length);
+  out.push(...data);
+};
+
+const toDocument = (bytes) => ({
+  encoding: CAPACITY_HISTORY_ENCODING,
+  data: Buffer.from(bytes).toString('base64')
+});
+
+// Test 1: sampel tepat, cm dari mm
+const bootA = 1792310400000;
+const bytes = [];
+encodeChunk(bytes, {
+  epochStart: bootA,
+  interval: 500,
+  samples: [{ mm: 120 }, { mm: 125 }, { mm: 118 }, { mm: 118, gap: 7300 }, { mm: 90 }]
+});
+let samples = decodeCapacityHistory(toDocument(bytes));
+assert(samples.length === 5, 'Jumlah sampel sesuai');
+assert(samples.map((s) => s.height).join() === '12,12.5,11.8,11.8,9', 'Nilai ketinggian (cm) sesuai');
+assert(
+  samples.map((s) => s.time - bootA).join() === '0,500,1000,8300,8800',
+  'Gap memakai jarak tersimpan, sampel biasa memakai interval'
+);
+
+// Test 2: chunk dari boot lain dalam satu batch tetap berurutan (epoch)
+const bootB = bootA + 3600000;
+encodeChunk(bytes, { epochStart: bootB, interval: 503, samples: [{ mm: 10 }, { mm: 11 }] });
+samples = decodeCapacityHistory(toDocument(bytes));
+assert(samples.length === 7 && samples[5].time === bootB && samples[6].time === bootB + 503, 'Chunk kedua memakai epoch sendiri');
+assert(samples.every((s, i) => i === 0 || s.time >= samples[i - 1].time), 'Waktu naik monoton');
+
+// Test 3: format lama (uptime) dan data terpotong ditolak
+let rejected = false;
+try {
+  decodeCapacityHistory({ encoding: 'zigzag-varint-delta-mm-v1', data: '' });
+} catch (error) {
+  rejected = true;
+}
+assert(rejected, 'Encoding v1 (uptime) ditolak');
+
+rejected = false;
+try {
+  decodeCapacityHistory(toDocument(bytes.slice(0, bytes.length - 1)));
+} catch (error) {
+  rejected = true;
+}
+assert(rejected, 'Data terpotong ditolak');
+
+console.log('\n🎉 Capacity history decoder test selesai');
@@ -0,0 +1,61 @@
+#pragma once
+
+// Pengganti minimal Arduino.h untuk menjalankan header firmware R1 di host.
+// Hanya bagian String yang dipakai header yang disediakan.
+
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+class String {
+public:
+  String() {}
+  String(const char* value) : data(value ? value : "") {}
+  String(const std::string& value) : data(value) {}
+
+  String& operator=(const char* value) {
+    data = value ? value : "";
+    return *this;
+  }
+  String& operator+=(const char* value) {
+    data += value;
+    return *this;
+  }
+  String& operator+=(char value) {
+    data += value;
+    return *this;
+  }
+  String& operator+=(const String& value) {
+    data += value.data;
+    return *this;
+  }
+  bool operator==(const String& other) const {
+    return data == other.data;
+  }
+  bool operator==(const char* other) const {
+    return data == other;
+  }
+
+  bool concat(const char* value, unsigned int length) {
+    data.append(value, length);
+    return true;
+  }
+  void reserve(unsigned int size) {
+    data.reserve(size);
+  }
+  const char* c_str() const {
+    return data.c_str();
+  }
+  unsigned int length() const {
+    return data.size();
+  }
+  bool isEmpty() const {
+    return data.empty();
+  }
+
+private:
+  std::string data;
+};
@@ -0,0 +1,167 @@
+#pragma once
+
+// Pembanding DOM untuk benchmark FirestoreSchema: seluruh response di-parse
+// ke tree node (seperti JsonDocument/FirebaseJson) lalu field dibaca lewat
+// lookup per key, sama dengan decoder manual R1 sebelum FirestoreSchema.
+// Hanya untuk host test, bukan parser JSON lengkap.
+
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+
+class JsonTree {
+public:
+  enum Type { NUL, BOOL, NUMBER, STRING, ARRAY, OBJECT };
+
+  Type type = NUL;
+  std::string text;  // string, atau literal number/bool
+  std::vector<JsonTree> items;
+  std::map<std::string, JsonTree> members;
+
+  static bool parse(const std::string& json, JsonTree& out) {
+    const char* p = json.c_str();
+    const char* end = p + json.size();
+    return parseValue(p, end, out);
+  }
+
+  const JsonTree& operator[](const char* key) const {
+    static const JsonTree missing;
+    auto it = members.find(key);
+    return it == members.end() ? missing : it->second;
+  }
+
+  // Seperti FirebaseJson::set("fields/nama/stringValue", value)
+  JsonTree& at(const std::string& path) {
+    JsonTree* node = this;
+    size_t start = 0;
+    while (start <= path.size()) {
+      size_t slash = path.find('/', start);
+      if (slash == std::string::npos) slash = path.size();
+      node->type = OBJECT;
+      node = &node->members[path.substr(start, slash - start)];
+      start = slash + 1;
+    }
+    return *node;
+  }
+
+  void setString(const std::string& path, const std::string& value) {
+    JsonTree& node = at(path);
+    node.type = STRING;
+    node.text = value;
+  }
+
+  void serialize(std::string& out) const {
+    switch (type) {
+      case NUL: out += "null"; break;
+      case BOOL:
+      case NUMBER: out += text; break;
+      case STRING: writeString(out, text); break;
+      case ARRAY:
+        out += '[';
+        for (size_t i = 0; i < items.size(); i++) {
+          if (i) out += ',';
+          items[i].serialize(out);
+        }
+        out += ']';
+        break;
+      case OBJECT: {
+        out += '{';
+        bool first = true;
+        for (const auto& member : members) {
+          if (!first) out += ',';
+          first = false;
+          writeString(out, member.first);
+          out += ':';
+          member.second.serialize(out);
+        }
+        out += '}';
+        break;
+      }
+    }
+  }
+
+private:
+  static void skipWhitespace(const char*& p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) p++;
+  }
+
+  static bool parseString(const char*& p, const char* end, std::string& out) {
+    if (p >= end || *p != '"') return false;
+    p++;
+    while (p < end && *p != '"') {
+      if (*p == '\\' && p + 1 < end) {
+        p++;
+        switch (*p) {
+          case 'n': out += '\n'; break;
+          case 'r': out += '\r'; break;
+          case 't': out += '\t'; break;
+          default: out += *p; break;
+        }
+      } else {
+        out += *p;
+      }
+      p++;
+    }
+    if (p >= end) return false;
+    p++;
+    return true;
+  }
+
+  static bool parseValue(const char*& p, const char* end, JsonTree& out) {
+    skipWhitespace(p, end);
+    if (p >= end) return false;
+    if (*p == '"') {
+      out.type = STRING;
+      return parseString(p, end, out.text);
+    }
+    if (*p == '{') {
+      out.type = OBJECT;
+      p++;
+      for (;;) {
+        skipWhitespace(p, end);
+        if (p < end && *p == '}') {
+          p++;
+          return true;
+        }
+        std::string key;
+        if (!parseString(p, end, key)) return false;
+        skipWhitespace(p, end);
+        if (p >= end || *p != ':') return false;
+        p++;
+        if (!parseValue(p, end, out.members[key])) return false;
+        skipWhitespace(p, end);
+        if (p < end && *p == ',') p++;
+      }
+    }
+    if (*p == '[') {
+      out.type = ARRAY;
+      p++;
+      for (;;) {
+        skipWhitespace(p, end);
+        if (p < end && *p == ']') {
+          p++;
+          return true;
+        }
+        out.items.emplace_back();
+        if (!parseValue(p, end, out.items.back())) return false;
+        skipWhitespace(p, end);
+        if (p < end && *p == ',') p++;
+      }
+    }
+    const char* start = p;
+    while (p < end && *p != ',' && *p != '}' && *p != ']' && *p != ' ') p++;
+    out.text.assign(start, p - start);
+    out.type = out.text == "null" ? NUL : (out.text == "true" || out.text == "false") ? BOOL : NUMBER;
+    return p > start;
+  }
+
+  static void writeString(std::string& out, const std::string& value) {
+    out += '"';
+    for (char c : value) {
+      if (c == '"' || c == '\\') out += '\\';
+      out += c;
+    }
+    out += '"';
+  }
+};
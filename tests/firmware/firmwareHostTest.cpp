@@ -0,0 +1,990 @@
+/**
+ * FIRMWARE HOST TEST - Header firmware R1 di host
+ *
+ * Test dan benchmark untuk header firmware yang tidak bergantung pada
+ * hardware (header .h di ignore-this-folder/firmware/ShintyaFirmwareR1), plus
+ * model waktu loop testing/esp32-framework.cpp. Arduino.h diganti stub di
+ * folder ini.
+ *
+ * Usage:
+ * ```bash
+ * npm run test-firmware
+ * ```
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../ignore-this-folder/firmware/ShintyaFirmwareR1/FirestoreSchema.h"
+#include "../../ignore-this-folder/firmware/ShintyaFirmwareR1/LokerSessions.h"
+#include "../../ignore-this-folder/firmware/ShintyaFirmwareR1/QrToken.h"
+#include "../../ignore-this-folder/firmware/ShintyaFirmwareR1/ScanQueue.h"
+#include "../../ignore-this-folder/firmware/ShintyaFirmwareR1/ServoPlanner.h"
+#include "JsonTree.h"
+
+// Pembanding tambahan, aktif jika ArduinoJson ada di include path:
+//   ARDUINOJSON_INCLUDE=-I<folder ArduinoJson/src> npm run test-firmware
+#if __has_include(<ArduinoJson.h>)
+#include <ArduinoJson.h>
+#define HAS_ARDUINOJSON 1
+#endif
+
+static int failures = 0;
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) { \
+      printf("  FAIL %s:%d %s\n", __FILE__, __LINE__, #cond); \
+      failures++; \
+    } \
+  } while (0)
+
+static uint32_t micros32() {
+  using namespace std::chrono;
+  return (uint32_t)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+////////// ScanQueue //////////
+
+static void testScanQueue() {
+  printf("ScanQueue\n");
+
+  ScanQueue<4> queue;
+  CHECK(queue.push("RESI1", SCAN_RESI, 0, 0, 1500));
+  CHECK(!queue.push("RESI1", SCAN_RESI, 0, 1000, 1500));  // pembacaan ganda
+  CHECK(!queue.push("RESI1", SCAN_RESI, 0, 2000, 1500));  // jendela debounce bergeser
+  CHECK(queue.push("RESI1", SCAN_RESI, 0, 4000, 1500));   // scan ulang selama flow 0
+  CHECK(queue.getStats().duplicates == 2);
+
+  CHECK(queue.push("USER1", SCAN_USER, 0, 4100, 1500));
+  CHECK(queue.push("RESI2", SCAN_RESI, 0, 4200, 1500));
+  CHECK(!queue.push("C", SCAN_ANY, 0, 4300, 1500));  // penuh
+  CHECK(queue.getStats().overflows == 1);
+
+  // Layar QR mengambil USER1 tanpa membuang resi di depannya
+  CHECK(queue.find(SCAN_USER) == 2);
+  queue.take(2, 4500);
+  CHECK(queue.getStats().latencyMax == 400);
+  CHECK(queue.size() == 4);
+  CHECK(queue.find(SCAN_USER) == -1);
+
+  // Layar resi mengambil yang tertua, latency dihitung dari timestamp scan
+  CHECK(queue.find(SCAN_RESI) == 0);
+  CHECK(strcmp(queue.at(0)->code, "RESI1") == 0);
+  queue.take(0, 4500);
+  CHECK(queue.getStats().latencyMax == 4500);
+
+  // Flow 0 selesai: scan ulang RESI1 dibuang, slot yang sudah diambil dilepas
+  CHECK(queue.discard("RESI1", 0, 4600) == 1);
+  CHECK(queue.getStats().discarded == 1);
+  CHECK(queue.size() == 1);
+  CHECK(strcmp(queue.at(0)->code, "RESI2") == 0);
+
+  // Kode yang ditolak karena overflow tidak ikut di-debounce
+  CHECK(queue.push("C", SCAN_ANY, 1, 4700, 1500));
+  // Scan ulang setelah flow selesai tetap diproses
+  CHECK(queue.push("RESI1", SCAN_RESI, 1, 4800, 1500));
+  CHECK(queue.discard("RESI1", 0, 4900) == 0);
+  CHECK(queue.size() == 3);
+  CHECK(queue.getStats().consumed == 2);
+}
+
+// Producer thread tanpa retry seperti scanTask: scan yang tidak muat dihitung
+// overflow. Setiap scan harus diterima tepat sekali atau tercatat overflow,
+// dan yang diterima tetap berurutan.
+static void stressScanQueue() {
+  const uint32_t SCANS = 200000;
+  ScanQueue<16> queue;
+  std::atomic<bool> done{ false };
+
+  std::thread producer([&]() {
+    char code[16];
+    for (uint32_t i = 0; i < SCANS; i++) {
+      snprintf(code, sizeof(code), "R%u", i);
+      queue.push(code, SCAN_ANY, 0, micros32(), 0);
+      std::this_thread::yield();
+    }
+    done = true;
+  });
+
+  uint32_t received = 0;
+  long last = -1;
+  bool ordered = true;
+  for (;;) {
+    bool finished = done.load();
+    const ScanEntry* entry = queue.at(0);
+    if (entry == nullptr) {
+      if (finished) break;
+      std::this_thread::yield();
+      continue;
+    }
+    long index = atol(entry->code + 1);
+    ordered &= index > last;
+    last = index;
+    queue.take(0, micros32());
+    received++;
+  }
+  producer.join();
+
+  const ScanStats& stats = queue.getStats();
+  printf("  stress: %u scans, diterima %u, overflow %u, urutan %s\n",
+         SCANS, received, stats.overflows, ordered ? "ok" : "SALAH");
+  CHECK(ordered);
+  CHECK(received == stats.consumed);
+  CHECK(stats.consumed + stats.overflows == SCANS);
+}
+
+// Antrian di loket: burst pelanggan scan resi berjarak 300 ms (GM67 membaca
+// tiap kode dua kali), sebagian scan ulang karena layar belum merespons.
+// Pelanggan hilang jika scan pertamanya overflow; scan ulang yang overflow
+// tidak menghilangkan pelanggan.
+// Producer tidak retry; consumer mengambil satu scan lalu terblokir selama
+// satu flow Non-COD (14 s delay() di Menu.ino). Waktu diskalakan 1 ms -> 1 us.
+static void benchScanQueue() {
+  const uint32_t SCAN_GAP_MS = 300;
+  const uint32_t DOUBLE_READ_MS = 200;
+  const uint32_t RESCAN_MS = 5000;  // tiap pelanggan ke-4 scan ulang
+  const uint32_t FLOW_MS = 14000;
+  const uint32_t IDLE_MS = 20;  // LOOP_IDLE_TIMEOUT_MS
+  const uint32_t bursts[] = { 8, 16, 24 };
+
+  for (uint32_t burst : bursts) {
+    struct Scan {
+      uint32_t at;
+      uint32_t customer;
+    };
+    std::vector<Scan> scans;
+    for (uint32_t c = 0; c < burst; c++) {
+      scans.push_back({ c * SCAN_GAP_MS, c });
+      scans.push_back({ c * SCAN_GAP_MS + DOUBLE_READ_MS, c });
+      if (c % 4 == 3) scans.push_back({ c * SCAN_GAP_MS + RESCAN_MS, c });
+    }
+    std::sort(scans.begin(), scans.end(), [](const Scan& a, const Scan& b) {
+      return a.at < b.at;
+    });
+
+    ScanQueue<16> queue;
+    std::atomic<uint32_t> flow{ 0 };
+    std::atomic<bool> done{ false };
+    uint32_t start = micros32();
+
+    std::thread producer([&]() {
+      char code[16];
+      for (const Scan& scan : scans) {
+        std::this_thread::sleep_until(std::chrono::steady_clock::now() + std::chrono::microseconds((int32_t)(scan.at - (micros32() - start))));
+        snprintf(code, sizeof(code), "RESI%03u", scan.customer);
+        queue.push(code, SCAN_ANY, flow.load(), micros32() - start, 1500);
+      }
+      done = true;
+    });
+
+    std::vector<bool> served(burst, false);
+    uint32_t servedTwice = 0;
+    for (;;) {
+      bool finished = done.load();
+      int16_t index = queue.find(SCAN_RESI);
+      if (index < 0) {
+        if (finished && queue.size() == 0) break;
+        std::this_thread::sleep_for(std::chrono::microseconds(IDLE_MS));
+        continue;
+      }
+      std::string code = queue.at(index)->code;
+      queue.take(index, micros32() - start);
+      uint32_t customer = atoi(code.c_str() + 4);
+      if (served[customer]) servedTwice++;
+      served[customer] = true;
+      std::this_thread::sleep_for(std::chrono::microseconds(FLOW_MS));
+      queue.discard(code.c_str(), flow.fetch_add(1), micros32() - start);
+    }
+    producer.join();
+
+    const ScanStats& stats = queue.getStats();
+    uint32_t lost = burst - (uint32_t)std::count(served.begin(), served.end(), true);
+    printf("  bench: burst %2u pelanggan, flow %u s: dilayani %2u, overflow %2u, pelanggan hilang %2u, scan ulang dibuang %u, dilayani dua kali %u, tunggu avg %.1f s max %.1f s\n",
+           burst, FLOW_MS / 1000, stats.consumed, stats.overflows, lost, stats.discarded, servedTwice,
+           stats.latencyTotal / 1000.0 / stats.consumed, stats.latencyMax / 1000.0);
+    CHECK(servedTwice == 0);
+    if (burst <= 16) CHECK(lost == 0);  // kapasitas gm67ScanQueue
+  }
+}
+
+////////// FirestoreSchema //////////
+
+// Sama dengan ResiData di Header.h
+struct ResiData {
+  String nama;
+  String noResi;
+  String packetType;
+  int resiId;
+};
+
+template<> struct FirestoreSchema<ResiData> {
+  template<typename V, typename D> static void fields(V& v, D& d) {
+    v("nama", d.nama);
+    v("noResi", d.noResi);
+    v("packetType", d.packetType);
+    v("resiId", d.resiId);
+  }
+};
+
+struct SensorData {
+  uint8_t loker;
+  uint16_t jarak;
+  unsigned int count;
+  long long epoch;
+  bool closed;
+  double kapasitas;
+};
+
+template<> struct FirestoreSchema<SensorData> {
+  template<typename V, typename D> static void fields(V& v, D& d) {
+    v("loker", d.loker);
+    v("jarak", d.jarak);
+    v("count", d.count);
+    v("epoch", d.epoch);
+    v("closed", d.closed);
+    v("kapasitas", d.kapasitas);
+  }
+};
+
+struct LokerData {
+  String nama;
+  SensorData sensor;
+};
+
+template<> struct FirestoreSchema<LokerData> {
+  template<typename V, typename D> static void fields(V& v, D& d) {
+    v("nama", d.nama);
+    v("sensor", d.sensor);
+  }
+};
+
+struct ActivityDocument {
+  String type;
+  FirestoreTimestamp createdAt;
+};
+
+template<> struct FirestoreSchema<ActivityDocument> {
+  template<typename V, typename D> static void fields(V& v, D& d) {
+    v("type", d.type);
+    v("createdAt", d.createdAt);
+  }
+};
+
+static std::string readFile(const char* path) {
+  std::ifstream file(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// Response runQuery/list Firestore dengan field tambahan yang harus dilewati
+static std::string firestoreResiResponse(size_t count) {
+  std::string json = "{\"documents\":[";
+  char doc[512];
+  for (size_t i = 0; i < count; i++) {
+    snprintf(doc, sizeof(doc),
+             "%s{\"name\":\"projects/p/databases/(default)/documents/receipts/r%zu\","
+             "\"fields\":{\"nama\":{\"stringValue\":\"Penerima \\\"%zu\\\"\"},"
+             "\"noResi\":{\"stringValue\":\"JNE%08zu\"},"
+             "\"packetType\":{\"stringValue\":\"COD\"},"
+             "\"resiId\":{\"integerValue\":\"%zu\"},"
+             "\"createdAt\":{\"timestampValue\":\"2026-10-18T08:00:00Z\"}},"
+             "\"createTime\":\"2026-10-18T08:00:00.000000Z\",\"updateTime\":\"2026-10-18T08:00:00.000000Z\"}",
+             i ? "," : "", i, i, i, i % 12 + 1);
+    json += doc;
+  }
+  json += "]}";
+  return json;
+}
+
+static void testFirestoreSchema() {
+  printf("FirestoreSchema\n");
+
+  // Integer sempit dan unsigned tidak boleh jatuh ke template mapValue
+  LokerData loker{"Loker 3", {3, 412, 4000000000u, 1792310400000LL, true, 62.5}};
+  String encoded = firestoreEncode(loker);
+  CHECK(strstr(encoded.c_str(), "\"count\":{\"integerValue\":\"4000000000\"}") != nullptr);
+  CHECK(strstr(encoded.c_str(), "\"sensor\":{\"mapValue\":{\"fields\":") != nullptr);
+
+  LokerData decoded{};
+  CHECK(firestoreDecodeDocument(encoded, decoded));
+  CHECK(decoded.nama == "Loker 3");
+  CHECK(decoded.sensor.loker == 3);
+  CHECK(decoded.sensor.jarak == 412);
+  CHECK(decoded.sensor.count == 4000000000u);
+  CHECK(decoded.sensor.epoch == 1792310400000LL);
+  CHECK(decoded.sensor.closed);
+  CHECK(decoded.sensor.kapasitas == 62.5);
+
+  ResiData resi[4]{};
+  std::string response = firestoreResiResponse(6);
+  CHECK(firestoreDecodeDocuments(String(response), resi, 4) == 4);
+  CHECK(resi[1].nama == "Penerima \"1\"");
+  CHECK(resi[3].noResi == "JNE00000003");
+  CHECK(resi[3].resiId == 4);
+
+  String empty = "{}";
+  CHECK(firestoreDecodeDocuments(empty, resi, 4) == 0);
+
+  // Fetch gagal (kosong/error/terpotong) tidak mengubah tabel
+  size_t count = 99;
+  CHECK(!firestoreDecodeTable(String(""), resi, 4, count));
+  CHECK(!firestoreDecodeTable(String("{\"error\":{\"code\":403}}"), resi, 4, count));
+  CHECK(!firestoreDecodeTable(String(response.substr(0, response.size() / 2)), resi, 4, count));
+  CHECK(count == 99 && resi[3].noResi == "JNE00000003");
+
+  // Koleksi kosong valid: tabel dikosongkan
+  CHECK(firestoreDecodeTable(empty, resi, 4, count));
+  CHECK(count == 0 && resi[0].noResi.isEmpty() && resi[3].resiId == 0);
+  CHECK(firestoreDecodeTable(String(firestoreResiResponse(2)), resi, 4, count));
+  CHECK(count == 2 && resi[1].noResi == "JNE00000001" && resi[2].noResi.isEmpty());
+
+  // timestampValue RFC 3339, jam belum diset -> nullValue
+  ActivityDocument activity{ "package_access", { 1792310400123LL } };
+  encoded = firestoreEncode(activity);
+  CHECK(strstr(encoded.c_str(), "\"createdAt\":{\"timestampValue\":\"2026-10-18T08:00:00.123Z\"}") != nullptr);
+  ActivityDocument activityDecoded{};
+  CHECK(firestoreDecodeDocument(encoded, activityDecoded));
+  CHECK(activityDecoded.createdAt.epochMs == 1792310400123LL);
+  activity.createdAt.epochMs = 0;
+  CHECK(strstr(firestoreEncode(activity).c_str(), "\"createdAt\":{\"nullValue\":null}") != nullptr);
+
+  FirestoreTimestamp timestamp;
+  CHECK(timestamp.parse("2026-10-18T15:00:00.5+07:00") && timestamp.epochMs == 1792310400500LL);
+  CHECK(timestamp.parse("1969-12-31T23:59:59Z") && timestamp.epochMs == -1000);
+  CHECK(timestamp.parse("2024-02-29T12:00:00.000000Z") && timestamp.epochMs == 1709208000000LL);
+  char formatted[48];
+  timestamp.format(formatted, sizeof(formatted));
+  CHECK(strcmp(formatted, "2024-02-29T12:00:00.000Z") == 0);
+  CHECK(!timestamp.parse("12345"));
+
+  // testing/esp32-framework.cpp memakai salinan header ini
+  CHECK(readFile("ignore-this-folder/firmware/ShintyaFirmwareR1/FirestoreSchema.h") == readFile("testing/FirestoreSchema.h"));
+}
+
+// Cara lama: parse seluruh response ke DOM lalu lookup per field
+static size_t decodeResiTree(const std::string& json, ResiData* out, size_t max) {
+  JsonTree doc;
+  if (!JsonTree::parse(json, doc)) return 0;
+  size_t count = 0;
+  for (const JsonTree& item : doc["documents"].items) {
+    if (count >= max) break;
+    const JsonTree& fields = item["fields"];
+    out[count].nama = fields["nama"]["stringValue"].text;
+    out[count].noResi = fields["noResi"]["stringValue"].text;
+    out[count].packetType = fields["packetType"]["stringValue"].text;
+    out[count].resiId = atoi(fields["resiId"]["integerValue"].text.c_str());
+    count++;
+  }
+  return count;
+}
+
+// Cara lama: FirebaseJson::set per field lalu serialize
+static std::string encodeResiTree(const ResiData* items, size_t count) {
+  JsonTree doc;
+  JsonTree& documents = doc.at("documents");
+  documents.type = JsonTree::ARRAY;
+  for (size_t i = 0; i < count; i++) {
+    documents.items.emplace_back();
+    JsonTree& item = documents.items.back();
+    item.setString("fields/nama/stringValue", items[i].nama.c_str());
+    item.setString("fields/noResi/stringValue", items[i].noResi.c_str());
+    item.setString("fields/packetType/stringValue", items[i].packetType.c_str());
+    item.setString("fields/resiId/integerValue", std::to_string(items[i].resiId));
+  }
+  std::string out;
+  doc.serialize(out);
+  return out;
+}
+
+#ifdef HAS_ARDUINOJSON
+static size_t decodeResiArduinoJson(const std::string& json, ResiData* out, size_t max) {
+#if ARDUINOJSON_VERSION_MAJOR >= 7
+  JsonDocument doc;
+#else
+  DynamicJsonDocument doc(json.size() * 2);
+#endif
+  if (deserializeJson(doc, json.c_str(), json.size())) return 0;
+  size_t count = 0;
+  for (JsonObject item : doc["documents"].as<JsonArray>()) {
+    if (count >= max) break;
+    JsonObject fields = item["fields"];
+    out[count].nama = fields["nama"]["stringValue"].as<const char*>();
+    out[count].noResi = fields["noResi"]["stringValue"].as<const char*>();
+    out[count].packetType = fields["packetType"]["stringValue"].as<const char*>();
+    out[count].resiId = atoi(fields["resiId"]["integerValue"].as<const char*>());
+    count++;
+  }
+  return count;
+}
+#endif
+
+template<typename F>
+static double averageMicros(uint32_t rounds, F&& run) {
+  uint32_t start = micros32();
+  for (uint32_t i = 0; i < rounds; i++) run();
+  return (double)(micros32() - start) / rounds;
+}
+
+// Ukuran sama dengan sinkronisasi R1: PAKET_MAX resi per response
+static void benchFirestoreSchema() {
+  const uint32_t ROUNDS = 20000;
+  std::string response = firestoreResiResponse(5);
+  String responseString(response);
+  ResiData resi[5]{};
+  size_t decoded = 0;
+
+  double schemaDecode = averageMicros(ROUNDS, [&]() {
+    decoded = firestoreDecodeDocuments(responseString, resi, 5);
+  });
+  CHECK(decoded == 5);
+  double schemaEncode = averageMicros(ROUNDS, [&]() {
+    String body = firestoreEncodeDocuments(resi, 5);
+    decoded = body.length();
+  });
+  printf("  bench: %zu byte, decode %.2f us, encode %.2f us (FirestoreSchema)\n",
+         response.size(), schemaDecode, schemaEncode);
+
+  double treeDecode = averageMicros(ROUNDS, [&]() {
+    decoded = decodeResiTree(response, resi, 5);
+  });
+  CHECK(decoded == 5);
+  double treeEncode = averageMicros(ROUNDS, [&]() {
+    decoded = encodeResiTree(resi, 5).size();
+  });
+  printf("  bench: decode %.2f us, encode %.2f us (DOM + lookup per field), rasio decode %.2fx encode %.2fx\n",
+         treeDecode, treeEncode, treeDecode / schemaDecode, treeEncode / schemaEncode);
+  CHECK(treeDecode > schemaDecode);
+  CHECK(treeEncode > schemaEncode);
+
+#ifdef HAS_ARDUINOJSON
+  double arduinoJsonDecode = averageMicros(ROUNDS, [&]() {
+    decoded = decodeResiArduinoJson(response, resi, 5);
+  });
+  CHECK(decoded == 5);
+  printf("  bench: decode %.2f us (deserializeJson ArduinoJson %d), rasio %.2fx\n",
+         arduinoJsonDecode, ARDUINOJSON_VERSION_MAJOR, arduinoJsonDecode / schemaDecode);
+#else
+  printf("  bench: pembanding deserializeJson dilewati (set ARDUINOJSON_INCLUDE)\n");
+#endif
+}
+
+////////// RFID event loop //////////
+
+// Model waktu loop() testing/esp32-framework.cpp: loop tidur di
+// waitForInputEvents() sampai IRQ MFRC522, echo sonar, atau REQA berikutnya,
+// dibandingkan dengan loop polling lama (PICC_IsNewCardPresent + delay(100)).
+// Interval sama dengan firmware; biaya per operasi adalah perkiraan untuk
+// SPI 4 MHz, LCD I2C 100 kHz dan wake dari light sleep.
+static const uint64_t RFID_ACTIVATE_US = 100000;  // RFID_ACTIVATE_INTERVAL
+static const uint64_t CAPACITY_CHECK_US = 500000;  // CAPACITY_CHECK_INTERVAL
+static const uint64_t DISPLAY_UPDATE_US = 1000000; // DISPLAY_UPDATE_INTERVAL
+static const uint64_t LEGACY_CAPACITY_CHECK_US = 5000000;
+static const uint64_t LEGACY_LOOP_DELAY_US = 100000;
+
+static const uint64_t COST_WAKE_US = 1000;         // light sleep -> loop task
+static const uint64_t COST_LOOP_US = 20;           // cek timer di loop()
+static const uint64_t COST_REQA_US = 30;           // 3 tulis register SPI
+static const uint64_t COST_CARD_ANSWER_US = 100;   // REQA + ATQA di udara
+static const uint64_t COST_CARD_READ_US = 4000;    // PICC_IsNewCardPresent + ReadCardSerial
+static const uint64_t COST_REQA_TIMEOUT_US = 25000; // PICC_IsNewCardPresent tanpa kartu (timer MFRC522)
+static const uint64_t COST_LCD_US = 14000;         // updateDisplay(): clear + 2 baris
+static const uint64_t COST_SONAR_US = 60;          // trigger + finishSonarMeasurement()
+static const uint64_t ECHO_US = 1200;              // pantulan ~20 cm
+static const uint64_t CARD_HOLD_US = 500000;       // lama kartu di atas reader
+
+struct RfidLoopResult {
+  double dutyCycle;  // % waktu di luar waitForInputEvents()/delay()
+  uint64_t latencyTotal;
+  uint64_t latencyMax;
+  uint64_t reportedTotal;  // IRQ -> respons, yang dikirim sebagai tapLatencyUs
+  uint32_t taps;
+};
+
+// Kartu menjawab REQA jika ada di atas reader dan belum di-HaltA
+static bool cardAnswers(const std::vector<uint64_t>& taps, size_t next, uint64_t t) {
+  return next < taps.size() && taps[next] <= t && t < taps[next] + CARD_HOLD_US;
+}
+
+static void recordTap(RfidLoopResult& result, uint64_t latency, uint64_t reported) {
+  result.latencyTotal += latency;
+  result.reportedTotal += reported;
+  if (latency > result.latencyMax) result.latencyMax = latency;
+  result.taps++;
+}
+
+static RfidLoopResult simulateEventLoop(const std::vector<uint64_t>& taps, uint64_t end) {
+  const uint64_t NONE = UINT64_MAX;
+  RfidLoopResult result{};
+  uint64_t t = 0, busy = 0;
+  uint64_t lastReqa = 0, lastSonar = 0, lastDisplay = 0;
+  uint64_t irqAt = NONE, echoAt = NONE;
+  size_t next = 0;
+
+  while (t < end) {
+    uint64_t wake = t + RFID_ACTIVATE_US;
+    if (irqAt != NONE && irqAt < wake) wake = std::max(irqAt, t);
+    if (echoAt != NONE && echoAt < wake) wake = std::max(echoAt, t);
+    t = wake + COST_WAKE_US;
+    uint64_t start = t;
+
+    t += COST_LOOP_US;
+    if (echoAt != NONE && echoAt <= t) {
+      echoAt = NONE;
+      t += COST_SONAR_US;
+    }
+    if (t - lastSonar > CAPACITY_CHECK_US) {
+      t += COST_SONAR_US;
+      echoAt = t + ECHO_US;
+      lastSonar = t;
+    }
+    if (irqAt != NONE && irqAt <= t) {
+      uint64_t irq = irqAt;
+      irqAt = NONE;
+      if (cardAnswers(taps, next, t)) {
+        t += COST_CARD_READ_US + COST_LCD_US;
+        recordTap(result, t - taps[next], t - irq);
+        next++;
+      }
+    }
+    while (next < taps.size() && taps[next] + CARD_HOLD_US <= t) next++;  // kartu diangkat sebelum terbaca
+    if (t - lastReqa >= RFID_ACTIVATE_US) {
+      t += COST_REQA_US;
+      lastReqa = t;
+      if (irqAt == NONE && cardAnswers(taps, next, t)) irqAt = t + COST_CARD_ANSWER_US;
+    }
+    if (t - lastDisplay > DISPLAY_UPDATE_US) {
+      t += COST_LCD_US;
+      lastDisplay = t;
+    }
+    busy += t - start;
+  }
+  result.dutyCycle = 100.0 * busy / t;
+  return result;
+}
+
+static RfidLoopResult simulatePollingLoop(const std::vector<uint64_t>& taps, uint64_t end) {
+  RfidLoopResult result{};
+  uint64_t t = 0, busy = 0;
+  uint64_t lastSonar = 0, lastDisplay = 0;
+  size_t next = 0;
+
+  while (t < end) {
+    uint64_t start = t;
+    t += COST_LOOP_US;
+    if (t - lastSonar > LEGACY_CAPACITY_CHECK_US) {
+      t += COST_SONAR_US + ECHO_US;  // ping_cm() menunggu echo
+      lastSonar = t;
+    }
+    while (next < taps.size() && taps[next] + CARD_HOLD_US <= t) next++;
+    if (cardAnswers(taps, next, t)) {
+      t += COST_CARD_READ_US + COST_LCD_US;
+      recordTap(result, t - taps[next], 0);
+      next++;
+    } else {
+      t += COST_REQA_TIMEOUT_US;
+    }
+    if (t - lastDisplay > DISPLAY_UPDATE_US) {
+      t += COST_LCD_US;
+      lastDisplay = t;
+    }
+    busy += t - start;
+    t += LEGACY_LOOP_DELAY_US;
+  }
+  result.dutyCycle = 100.0 * busy / t;
+  return result;
+}
+
+// Satu jam idle untuk duty cycle, lalu tap acak tiap ~10 s untuk latency
+static void benchRfidLoop() {
+  printf("RFID event loop\n");
+  const uint64_t HOUR_US = 3600ULL * 1000000;
+  std::vector<uint64_t> noTaps;
+  std::vector<uint64_t> taps;
+  uint32_t seed = 12345;
+  for (uint64_t t = 1000000; t < HOUR_US; t += 10000000) {
+    seed = seed * 1103515245 + 12345;
+    taps.push_back(t + (seed >> 8) % 1000000);
+  }
+
+  RfidLoopResult eventIdle = simulateEventLoop(noTaps, HOUR_US);
+  RfidLoopResult pollingIdle = simulatePollingLoop(noTaps, HOUR_US);
+  RfidLoopResult event = simulateEventLoop(taps, HOUR_US);
+  RfidLoopResult polling = simulatePollingLoop(taps, HOUR_US);
+
+  printf("  bench: duty cycle idle %.2f%% (polling %.2f%%)\n", eventIdle.dutyCycle, pollingIdle.dutyCycle);
+  printf("  bench: tap -> respons avg %.1f ms max %.1f ms, %u tap (polling avg %.1f ms max %.1f ms, %u tap)\n",
+         event.latencyTotal / 1000.0 / event.taps, event.latencyMax / 1000.0, event.taps,
+         polling.latencyTotal / 1000.0 / polling.taps, polling.latencyMax / 1000.0, polling.taps);
+  printf("  bench: tapLatencyUs (IRQ -> respons) avg %.1f ms, sisanya menunggu REQA\n",
+         event.reportedTotal / 1000.0 / event.taps);
+  CHECK(event.taps == taps.size());
+  CHECK(polling.taps == taps.size());
+  CHECK(eventIdle.dutyCycle < pollingIdle.dutyCycle);
+  CHECK(event.latencyTotal / event.taps < polling.latencyTotal / polling.taps);
+}
+
+////////// LokerSessions //////////
+
+// Sama dengan SERVO_PLANNER_CONFIG, LOKER_SESSION_CONFIG dan posisi loker di Header.h
+static const ServoPlannerConfig SERVO_CONFIG = { 1500, 650, 250, 80, 960, 150 };
+static const uint16_t SERVO_LOCK = 0;
+static const uint16_t SERVO_UNLOCK = 240;
+static const uint32_t SERVO_FRAME_MS = 20;  // LOKER_TASK_PERIOD_MS
+static const LokerSessionConfig LOKER_CONFIG = { 30000, 120000, SERVO_LOCK, SERVO_UNLOCK };
+
+static bool lokerDoorOpen[12];
+
+static bool lokerDoorClosed(uint8_t nomorLoker) {
+  return !lokerDoorOpen[nomorLoker - 1];
+}
+
+static void testLokerSessions() {
+  printf("LokerSessions\n");
+
+  ServoPlanner<12> planner(SERVO_CONFIG, nullptr, SERVO_LOCK);
+  LokerSessionTable<12> table(LOKER_CONFIG, planner, lokerDoorClosed);
+  std::fill(std::begin(lokerDoorOpen), std::end(lokerDoorOpen), false);
+
+  uint32_t now = 0;
+  bool alarm = false;
+  auto runUntil = [&](uint32_t until) {
+    while (now < until) {
+      now += SERVO_FRAME_MS;
+      planner.update(now);
+      alarm = table.update(now);
+    }
+  };
+
+  CHECK(!table.open(0, SESSION_DEPOSIT, "RESI0", now));
+  CHECK(!table.open(13, SESSION_DEPOSIT, "RESI13", now));
+  CHECK(table.open(1, SESSION_DEPOSIT, "RESI1", now));
+  CHECK(!table.open(1, SESSION_PICKUP, "user", now));  // loker sedang dipakai
+  CHECK(table.open(2, SESSION_PICKUP, "user", now));
+  CHECK(table.getStats().rejected == 3);
+  CHECK(table.activeCount() == 2);
+
+  // Loker 1: pintu dibuka lalu ditutup -> selesai dan dikunci lagi
+  runUntil(1000);
+  lokerDoorOpen[0] = true;
+  runUntil(5000);
+  CHECK(table.get(1).state == LOKER_DOOR_OPEN);
+  lokerDoorOpen[0] = false;
+  runUntil(5020);
+  CHECK(!table.isBusy(1));
+  CHECK(table.getStats().completed == 1);
+  runUntil(6000);
+  CHECK(planner.getPosition(0) == SERVO_LOCK);
+
+  // Loker 2: pintu tidak pernah dibuka -> kadaluarsa 30 s setelah kunci terbuka
+  runUntil(30000);
+  CHECK(table.isBusy(2));
+  runUntil(30400);
+  CHECK(!table.isBusy(2));
+  CHECK(table.getStats().expired == 1);
+
+  // Loker 3: pintu dibiarkan terbuka -> alarm sampai ditutup
+  CHECK(table.open(3, SESSION_DEPOSIT, "RESI3", now));
+  runUntil(now + 1000);
+  lokerDoorOpen[2] = true;
+  runUntil(now + SERVO_FRAME_MS);  // pintu terdeteksi terbuka
+  CHECK(table.get(3).state == LOKER_DOOR_OPEN);
+  runUntil(now + LOKER_CONFIG.doorAlarmMs - SERVO_FRAME_MS);
+  CHECK(!alarm);
+  runUntil(now + SERVO_FRAME_MS);
+  CHECK(alarm);
+  lokerDoorOpen[2] = false;
+  runUntil(now + SERVO_FRAME_MS);
+  CHECK(!alarm);
+  CHECK(table.getStats().completed == 2);
+}
+
+struct LokerPointResult {
+  uint32_t customers;
+  uint32_t waitingForLoker;  // frame kiosk menunggu loker kosong/berisi
+  LokerSessionStats sessions;
+  ServoPlannerStats servo;
+};
+
+// Titik ambil yang ramai selama satu jam virtual: antrian kurir (deposit) dan
+// penerima (pickup 1..3 loker) tidak pernah kosong. Kiosk menjalankan flow
+// menu, membuka sesi, lalu pelanggan berjalan ke loker, membuka pintu dan
+// menutupnya lagi. Mode paralel memakai tabel sesi seperti lokerTask; mode
+// serial meniru R1 sebelum tabel sesi (satu ambilPaketState), kiosk baru
+// melayani pelanggan berikutnya setelah semua loker terkunci lagi.
+static LokerPointResult simulateLokerPoint(bool parallel) {
+  const uint32_t HOUR_MS = 3600000;
+  const uint32_t FLOW_MS = 14000;     // scan + layar Menu.ino sampai sesi dibuka
+  const uint32_t WALK_MS = 4000;      // layar -> pintu loker
+  const uint32_t DEPOSIT_MS = 12000;  // pintu terbuka, paket dimasukkan
+  const uint32_t PICKUP_MS = 8000;    // per loker, dibuka satu per satu
+  const uint32_t ABANDON_EVERY = 10;  // pelanggan ke-10 tidak membuka pintu
+
+  ServoPlanner<12> planner(SERVO_CONFIG, nullptr, SERVO_LOCK);
+  LokerSessionTable<12> table(LOKER_CONFIG, planner, lokerDoorClosed);
+  std::fill(std::begin(lokerDoorOpen), std::end(lokerDoorOpen), false);
+
+  bool full[12];
+  uint32_t doorOpenAt[12] = {};
+  uint32_t doorCloseAt[12] = {};
+  for (uint8_t i = 0; i < 12; i++) full[i] = i % 2;
+
+  LokerPointResult result{};
+  uint32_t rng = 12345;
+  auto next = [&rng]() {
+    rng = rng * 1103515245 + 12345;
+    return rng >> 16;
+  };
+
+  bool inFlow = false;
+  uint32_t flowEnd = 0;
+  for (uint32_t now = 0; now < HOUR_MS; now += SERVO_FRAME_MS) {
+    for (uint8_t i = 0; i < 12; i++) {
+      if (doorOpenAt[i] && now >= doorOpenAt[i]) {
+        lokerDoorOpen[i] = true;
+        doorOpenAt[i] = 0;
+      }
+      if (doorCloseAt[i] && now >= doorCloseAt[i]) {
+        lokerDoorOpen[i] = false;
+        doorCloseAt[i] = 0;
+        full[i] = table.get(i + 1).type == SESSION_DEPOSIT;
+      }
+    }
+
+    if (!inFlow && (parallel || table.activeCount() == 0)) {
+      inFlow = true;
+      flowEnd = now + FLOW_MS;
+    }
+
+    if (inFlow && now >= flowEnd) {
+      // Tidak ada loker kosong (deposit) atau berisi (pickup): layani jenis lain
+      bool deposit = next() % 2;
+      uint8_t pickups = 1 + next() % 3;
+      uint8_t offset = next() % 12;
+      uint8_t opened = 0;
+      for (uint8_t pass = 0; pass < 2 && opened == 0; pass++, deposit = !deposit) {
+        uint8_t wanted = deposit ? 1 : pickups;
+        for (uint8_t k = 0; k < 12 && opened < wanted; k++) {
+          uint8_t i = (offset + k) % 12;
+          if (table.isBusy(i + 1) || full[i] == deposit) continue;
+          if (!table.open(i + 1, deposit ? SESSION_DEPOSIT : SESSION_PICKUP, "sim", now)) continue;
+          if (result.customers % ABANDON_EVERY != ABANDON_EVERY - 1) {
+            uint32_t handle = deposit ? DEPOSIT_MS : PICKUP_MS;
+            doorOpenAt[i] = now + WALK_MS + opened * PICKUP_MS;
+            doorCloseAt[i] = doorOpenAt[i] + handle;
+          }
+          opened++;
+        }
+      }
+      if (opened > 0) {
+        result.customers++;
+        inFlow = false;
+      } else {
+        result.waitingForLoker++;
+      }
+    }
+
+    planner.update(now);
+    table.update(now);
+  }
+
+  result.sessions = table.getStats();
+  result.servo = planner.getStats();
+  return result;
+}
+
+static void benchLokerSessions() {
+  LokerPointResult serial = simulateLokerPoint(false);
+  LokerPointResult parallel = simulateLokerPoint(true);
+
+  for (const LokerPointResult* r : { &serial, &parallel }) {
+    const LokerSessionStats& s = r->sessions;
+    printf("  bench: %-7s %3u transaksi/jam (%3u pelanggan, %2u kadaluarsa), sesi aktif max %2u, "
+           "durasi avg %.1f s max %.1f s, servo tunggu max %3u ms, puncak %4u mA\n",
+           r == &serial ? "serial" : "paralel", s.completed, r->customers, s.expired, s.peakActive,
+           s.durationTotal / 1000.0 / s.completed, s.durationMax / 1000.0, r->servo.waitMax,
+           r->servo.peakLoadMa);
+    CHECK(r->servo.peakLoadMa <= SERVO_CONFIG.budgetMa);
+    CHECK(s.rejected == 0);
+  }
+  printf("  bench: paralel %.2fx transaksi/jam, kiosk menunggu loker %u frame\n",
+         (double)parallel.sessions.completed / serial.sessions.completed, parallel.waitingForLoker);
+  CHECK(parallel.sessions.completed > serial.sessions.completed);
+  CHECK(parallel.sessions.peakActive > serial.sessions.peakActive);
+}
+
+////////// ServoPlanner //////////
+
+static uint16_t servoWritten[12];
+
+static void testServoPlanner() {
+  printf("ServoPlanner\n");
+
+  ServoPlanner<12> planner(SERVO_CONFIG, [](uint8_t channel, uint16_t position) {
+    servoWritten[channel] = position;
+  }, SERVO_LOCK);
+
+  // Budget 1500 mA: dua inrush (1300 mA) boleh jalan, yang ketiga menunggu
+  for (uint8_t i = 0; i < 3; i++) planner.request(i, SERVO_UNLOCK, 0);
+  planner.update(0);
+  CHECK(planner.currentLoad(0) == 1300);
+  CHECK(!planner.isSettled(2));
+  planner.update(100);  // keduanya sudah lewat inrush: 2 x 250 + 650 <= 1500
+  CHECK(planner.currentLoad(100) == 1150);
+
+  // Request berlawanan sebelum mulai bergerak saling menghapus
+  planner.request(5, SERVO_UNLOCK, 100);
+  planner.request(5, SERVO_LOCK, 100);
+  CHECK(planner.isSettled(5));
+  CHECK(planner.getStats().coalesced == 1);
+
+  uint32_t now = 100;
+  while (!planner.isIdle()) planner.update(now += SERVO_FRAME_MS);
+  CHECK(servoWritten[0] == SERVO_UNLOCK && servoWritten[2] == SERVO_UNLOCK);
+  CHECK(planner.getStats().completed == 3);
+  CHECK(planner.getStats().peakLoadMa <= SERVO_CONFIG.budgetMa);
+}
+
+// Membuka N pintu sekaligus dengan waktu virtual per frame, dibandingkan
+// dengan membuka satu per satu dan membuka semuanya tanpa planner
+static void benchServoPlanner() {
+  for (uint8_t pintu : { 1, 4, 12 }) {
+    ServoPlanner<12> planner(SERVO_CONFIG, nullptr, SERVO_LOCK);
+    uint32_t now = 0;
+    for (uint8_t i = 0; i < pintu; i++) planner.request(i, SERVO_UNLOCK, now);
+    do {
+      planner.update(now);
+      now += SERVO_FRAME_MS;
+    } while (!planner.isIdle());
+
+    const ServoPlannerStats& stats = planner.getStats();
+    uint32_t serialTime = pintu * planner.motionTime(SERVO_LOCK, SERVO_UNLOCK);
+    printf("  bench: %2u pintu, planner %4u ms (satu per satu %4u ms), tunggu max %3u ms, "
+           "puncak %4u mA (tanpa planner %4u mA)\n",
+           pintu, stats.lastDone - stats.firstStart, serialTime, stats.waitMax,
+           stats.peakLoadMa, pintu * SERVO_CONFIG.inrushMa);
+    CHECK(stats.peakLoadMa <= SERVO_CONFIG.budgetMa);
+    CHECK(stats.completed == pintu);
+  }
+
+  // Biaya satu update() di frame lokerTask dengan 12 servo bergerak
+  const uint32_t ROUNDS = 200000;
+  ServoPlanner<12> planner(SERVO_CONFIG, [](uint8_t channel, uint16_t position) {
+    servoWritten[channel] = position;
+  }, SERVO_LOCK);
+  uint32_t start = micros32();
+  for (uint32_t i = 0; i < ROUNDS; i++) {
+    if (planner.isIdle()) {
+      for (uint8_t ch = 0; ch < 12; ch++) planner.request(ch, i % 2 ? SERVO_LOCK : SERVO_UNLOCK, i);
+    }
+    planner.update(i);
+  }
+  printf("  bench: update() %.3f us per frame\n", (double)(micros32() - start) / ROUNDS);
+}
+
+////////// QrToken //////////
+
+// Dibuat oleh tests/generateFirmwareQRVectors.js
+struct QrVector {
+  std::string expect;
+  uint64_t nowMs;
+  std::string email;
+  std::string token;
+};
+
+static std::vector<QrVector> loadQrVectors() {
+  std::vector<QrVector> vectors;
+  std::ifstream file("tests/firmware/qrVectors.txt");
+  std::string line;
+  while (std::getline(file, line)) {
+    size_t a = line.find('|');
+    size_t b = line.find('|', a + 1);
+    size_t c = line.find('|', b + 1);
+    if (c == std::string::npos) continue;
+    vectors.push_back({ line.substr(0, a), strtoull(line.c_str() + a + 1, nullptr, 10),
+                        line.substr(b + 1, c - b - 1), line.substr(c + 1) });
+  }
+  return vectors;
+}
+
+static const char* qrResultName(QrTokenResult result) {
+  switch (result) {
+    case QR_TOKEN_OK: return "ok";
+    case QR_TOKEN_FORMAT: return "format";
+    case QR_TOKEN_PADDING: return "padding";
+    case QR_TOKEN_PAYLOAD: return "payload";
+    case QR_TOKEN_EXPIRED: return "expired";
+  }
+  return "unknown";
+}
+
+static QrTokenVerifier qrVerifier;
+
+static void testQrToken() {
+  printf("QrToken\n");
+
+  // Sama dengan QR_USER_SECRET / QR_USER_DERIVATION di Header.h
+  uint32_t start = micros32();
+  qrVerifier.begin("SHINTYA_AES_USER_2024", "user_qr");
+  printf("  begin (PBKDF2 1000 iterasi): %u us\n", micros32() - start);
+
+  std::vector<QrVector> vectors = loadQrVectors();
+  CHECK(vectors.size() >= 9);
+  for (const QrVector& vector : vectors) {
+    QrTokenPayload payload;
+    QrTokenResult result = qrVerifier.verify(vector.token.c_str(), payload, vector.nowMs);
+    if (vector.expect != qrResultName(result)) {
+      printf("  FAIL %s: hasil %s, seharusnya %s\n", vector.token.substr(0, 40).c_str(), qrResultName(result), vector.expect.c_str());
+      failures++;
+    }
+    if (result == QR_TOKEN_OK) CHECK(vector.email == payload.email);
+  }
+
+  CHECK(!QrTokenVerifier::isToken("USER#admin"));
+  CHECK(qrConstantTimeEquals("admin", "admin", QR_TOKEN_FIELD_MAX));
+  CHECK(!qrConstantTimeEquals("admin", "admin2", QR_TOKEN_FIELD_MAX));
+}
+
+// Waktu verifikasi satu token sah (AES + EVP_BytesToKey + parse JSON)
+static void benchQrToken() {
+  std::vector<QrVector> vectors = loadQrVectors();
+  if (vectors.empty()) return;
+  const uint32_t ROUNDS = 20000;
+  uint32_t verifyMax = 0;
+  uint32_t accepted = 0;
+  uint32_t total = micros32();
+  for (uint32_t i = 0; i < ROUNDS; i++) {
+    const QrVector& vector = vectors[i % 3];
+    QrTokenPayload payload;
+    uint32_t start = micros32();
+    accepted += qrVerifier.verify(vector.token.c_str(), payload, vector.nowMs) == QR_TOKEN_OK;
+    uint32_t elapsed = micros32() - start;
+    if (elapsed > verifyMax) verifyMax = elapsed;
+  }
+  total = micros32() - total;
+  printf("  bench: verify avg %.2f us max %u us (%u token)\n", (double)total / ROUNDS, verifyMax, ROUNDS);
+  CHECK(accepted == ROUNDS);
+}
+
+int main() {
+  testScanQueue();
+  stressScanQueue();
+  benchScanQueue();
+  testFirestoreSchema();
+  benchFirestoreSchema();
+  benchRfidLoop();
+  testLokerSessions();
+  benchLokerSessions();
+  testServoPlanner();
+  benchServoPlanner();
+  testQrToken();
+  benchQrToken();
+
+  printf("%s\n", failures ? "FAILED" : "OK");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,133 @@
+#!/usr/bin/env node
+
+/**
+ * FIRMWARE QR TEST VECTORS - AES V3 User QR
+ *
+ * Generate tests/firmware/qrVectors.txt untuk host test verifier firmware R1
+ * (QrToken.h, lihat `npm run test-firmware`). Token dibuat dengan format yang
+ * sama seperti AESV3Instances.userQR.encrypt(): passphrase PBKDF2-SHA256 dari
+ * secret, lalu CryptoJS.AES passphrase mode (EVP_BytesToKey MD5, AES-256-CBC,
+ * "Salted__" + salt). Salt dan timestamp tetap sehingga file deterministik.
+ *
+ * Jika crypto-js dan service V3 bisa di-load (npm install), setiap token juga
+ * didekripsi dengan key AESV3Instances.userQR sebagai cross-check.
+ *
+ * Usage:
+ * ```bash
+ * node tests/generateFirmwareQRVectors.js
+ * ```
+ *
+ * Format baris: expect|nowMs|email|token
+ *   expect: ok, format, padding, payload, expired (QrTokenResult)
+ *   nowMs: jam device saat verifikasi, 0 = jam belum sinkron
+ *
+ * @author Shintya Package Delivery System
+ * @version 2.0.0
+ */
+
+import crypto from 'node:crypto';
+import fs from 'node:fs';
+import { fileURLToPath } from 'node:url';
+import { dirname, join } from 'node:path';
+
+const __dirname = dirname(fileURLToPath(import.meta.url));
+const OUTPUT = join(__dirname, 'firmware', 'qrVectors.txt');
+
+// Harus sama dengan AESV3Instances.userQR dan QR_USER_SECRET di firmware
+const SECRET = 'SHINTYA_AES_USER_2024';
+const DERIVATION = 'user_qr';
+const ISSUED_AT = 1792310400000; // timestamp tetap di payload token
+const HOUR = 60 * 60 * 1000;
+
+const passphrase = crypto
+  .pbkdf2Sync(SECRET, `SHINTYA_AES_SALT_2024_${DERIVATION}`, 1000, 16, 'sha256')
+  .toString('hex');
+
+// Salt/IV/nonce diturunkan dari label agar output stabil antar run
+const seeded = (label, length) => crypto.createHash('sha256').update(label).digest().subarray(0, length);
+
+const evpBytesToKey = (salt) => {
+  let derived = Buffer.alloc(0);
+  let block = Buffer.alloc(0);
+  while (derived.length < 48) {
+    block = crypto.createHash('md5').update(Buffer.concat([block, Buffer.from(passphrase), salt])).digest();
+    derived = Buffer.concat([derived, block]);
+  }
+  return { key: derived.subarray(0, 32), iv: derived.subarray(32, 48) };
+};
+
+const encryptToken = (label, data, timestamp = ISSUED_AT) => {
+  // Field sama dengan AESEncryptionServiceV3.encrypt()
+  const json = JSON.stringify({
+    ...data,
+    timestamp,
+    nonce: seeded(`nonce:${label}`, 8).toString('hex'),
+    version: '3.0.0',
+    algorithm: 'AES-128-CBC',
+    cryptoProvider: 'expo-crypto'
+  });
+  const salt = seeded(`salt:${label}`, 8);
+  const { key, iv } = evpBytesToKey(salt);
+  const cipher = crypto.createCipheriv('aes-256-cbc', key, iv);
+  const ciphertext = Buffer.concat([cipher.update(json, 'utf8'), cipher.final()]);
+  const payload = Buffer.concat([Buffer.from('Salted__'), salt, ciphertext]).toString('base64');
+  return `${seeded(`iv:${label}`, 16).toString('hex')}:${payload}`;
+};
+
+// Hasil yang diharapkan untuk token yang dimodifikasi, dihitung dengan
+// dekripsi tanpa auto padding seperti firmware
+const expectTampered = (token) => {
+  const raw = Buffer.from(token.split(':')[1], 'base64');
+  const { key, iv } = evpBytesToKey(raw.subarray(8, 16));
+  const decipher = crypto.createDecipheriv('aes-256-cbc', key, iv);
+  decipher.setAutoPadding(false);
+  const data = Buffer.concat([decipher.update(raw.subarray(16)), decipher.final()]);
+  const pad = data[data.length - 1];
+  const validPad = pad >= 1 && pad <= 16 && data.subarray(data.length - pad).every((b) => b === pad);
+  return validPad ? 'payload' : 'padding';
+};
+
+const users = [
+  { email: 'user1@gmail.com', nama: 'Test User' },
+  { email: 'admin@gmail.com', nama: 'admin' },
+  { email: 'kurir.shintya@gmail.com', nama: 'Kurir Shintya' }
+];
+
+const vectors = [];
+for (const user of users) {
+  vectors.push({ expect: 'ok', nowMs: ISSUED_AT + 60000, email: user.email, token: encryptToken(user.email, user) });
+}
+
+const user1 = vectors[0].token;
+vectors.push({ expect: 'ok', nowMs: 0, email: users[0].email, token: user1 });                      // jam belum sinkron
+vectors.push({ expect: 'expired', nowMs: ISSUED_AT + 25 * HOUR, email: '', token: user1 });          // lewat maxAge 24 jam
+vectors.push({ expect: 'expired', nowMs: ISSUED_AT - 10 * 60000, email: '', token: user1 });         // timestamp di masa depan
+
+const [ivHex, payload] = user1.split(':');
+const flipped = payload.slice(0, -6) + (payload.at(-6) === 'A' ? 'B' : 'A') + payload.slice(-5);
+const tampered = `${ivHex}:${flipped}`;
+vectors.push({ expect: expectTampered(tampered), nowMs: 0, email: '', token: tampered });
+vectors.push({ expect: 'format', nowMs: 0, email: '', token: `${ivHex}:bukan-base64!` });
+vectors.push({ expect: 'payload', nowMs: 0, email: '', token: encryptToken('tanpa-email', { nama: 'Tanpa Email' }) });
+
+// Cross-check dengan service aplikasi jika dependency tersedia
+try {
+  const { default: CryptoJS } = await import('crypto-js');
+  const { AESV3Instances } = await import('../services/aesEncryptionServiceV3.js');
+  if (AESV3Instances.userQR.encryptionKey !== passphrase) {
+    throw new Error('Passphrase berbeda dengan AESV3Instances.userQR');
+  }
+  for (const vector of vectors.filter((v) => v.expect === 'ok')) {
+    const json = CryptoJS.AES.decrypt(vector.token.split(':')[1], passphrase).toString(CryptoJS.enc.Utf8);
+    if (JSON.parse(json).email !== vector.email) {
+      throw new Error(`Cross-check gagal untuk ${vector.email}`);
+    }
+  }
+  console.log('// cross-check crypto-js: ok');
+} catch (error) {
+  if (error.code !== 'ERR_MODULE_NOT_FOUND') throw error;
+  console.log('// cross-check crypto-js dilewati (jalankan npm install)');
+}
+
+fs.writeFileSync(OUTPUT, vectors.map((v) => `${v.expect}|${v.nowMs}|${v.email}|${v.token}`).join('\n') + '\n');
+console.log(`// ${vectors.length} vector ditulis ke ${OUTPUT}`);
@@ -0,0 +1,99 @@
+/**
+ * Decoder riwayat kapasitas dari ESP32 (capacity/box_sensor/history).
+ * 
+ * Dipisah dari capacityService agar bisa dites di Node tanpa Firebase.
+ */
+
+export const CAPACITY_HISTORY_ENCODING = 'zigzag-varint-delta-mm-v2';
+const BASE64_ALPHABET = 'ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/';
+
+const zigzagDecode = (zigzag) => (zigzag % 2 === 0 ? zigzag / 2 : -(zigzag + 1) / 2);
+
+/**
+ * Decode batch riwayat kapasitas yang dikirim ESP32.
+ * 
+ * ESP32 mengambil sampel ketinggian setiap ~0.5 detik dan mengirimnya
+ * secara batch ke capacity/box_sensor/history. Field `data` berisi base64
+ * dari satu atau lebih chunk dengan format:
+ *   varint epochStart | varint interval | varint count | varint length | data
+ * dimana `data` adalah zigzag varint: sampel pertama nilai absolut (mm),
+ * sampel berikutnya (selisih << 1 | gap). Jika bit gap di-set, setelahnya
+ * ada varint jarak waktu (ms) ke sampel sebelumnya; tanpa gap jaraknya
+ * sama dengan `interval`.
+ * 
+ * @function decodeCapacityHistory
+ * @param {Object} historyDoc - Dokumen history dari Firestore
+ * @returns {Array<Object>} Daftar sampel { time, height } dengan:
+ *   - time: number - Waktu sampel diambil (epoch ms)
+ *   - height: number - Ketinggian paket dalam cm
+ * 
+ * @example
+ * const samples = decodeCapacityHistory(docSnap.data());
+ * samples.forEach(({ time, height }) => console.log(new Date(time), height));
+ */
+export const decodeCapacityHistory = (historyDoc) => {
+  // v1 memakai uptime ESP32 yang tidak bisa diurutkan antar reboot
+  if (!historyDoc || historyDoc.encoding !== CAPACITY_HISTORY_ENCODING) {
+    throw new Error(`Unsupported capacity history encoding: ${historyDoc?.encoding}`);
+  }
+
+  // Decode base64 manual agar tidak bergantung pada atob/Buffer di React Native
+  const clean = (historyDoc.data || '').replace(/=+$/, '');
+  const bytes = [];
+  let buffer = 0;
+  let bits = 0;
+  for (const char of clean) {
+    const index = BASE64_ALPHABET.indexOf(char);
+    if (index < 0) continue;
+    buffer = ((buffer << 6) | index) & 0xffff;
+    bits += 6;
+    if (bits >= 8) {
+      bits -= 8;
+      bytes.push((buffer >> bits) & 0xff);
+    }
+  }
+
+  let offset = 0;
+  const readVarint = () => {
+    let value = 0;
+    let scale = 1;
+    while (offset < bytes.length) {
+      const byte = bytes[offset++];
+      value += (byte & 0x7f) * scale;
+      if ((byte & 0x80) === 0) return value;
+      scale *= 128;
+    }
+    throw new Error('Truncated capacity history data');
+  };
+
+  const samples = [];
+  while (offset < bytes.length) {
+    const epochStart = readVarint();
+    const interval = readVarint();
+    const count = readVarint();
+    const length = readVarint();
+    const chunkEnd = offset + length;
+
+    let value = 0;
+    let time = epochStart;
+    for (let i = 0; i < count; i++) {
+      const encoded = readVarint();
+      if (i === 0) {
+        value = zigzagDecode(encoded);
+      } else {
+        const gap = encoded % 2 === 1;
+        value += zigzagDecode(Math.floor(encoded / 2));
+        time += gap ? readVarint() : interval;
+      }
+      samples.push({
+        time,
+        height: value / 10 // mm -> cm
+      });
+    }
+    if (offset !== chunkEnd) {
+      throw new Error('Corrupt capacity history chunk');
+    }
+  }
+
+  return samples;
+};